@@ -0,0 +1,131 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <numeric>
+#include <thread>
+#include "Benchmark.h"
+
+/**
+ * Constructor for the benchmark runner.
+ * @param minimumTime Minimum total wall clock time of the measured iterations of a benchmark, in seconds.
+ * @param minimumIterations Minimum number of measured iterations of a benchmark.
+ * @param filter Only the benchmarks whose full name contains the filter are run; all of them if it is empty.
+ */
+Benchmark::Benchmark(double minimumTime, int minimumIterations, const string& filter){
+    this->minimumTime = minimumTime;
+    this->minimumIterations = max(1, minimumIterations);
+    this->filter = filter;
+}
+
+/**
+ * Returns the full name of a benchmark with its parameters, such as ProbabilisticCYKParser/length:20/nonTerminals:32.
+ * @param name Name of the benchmark.
+ * @param parameters Names and values of the parameters.
+ * @return Full name of the benchmark.
+ */
+string Benchmark::fullName(const string& name, const vector<pair<string, int>>& parameters){
+    string result = name;
+    for (const auto& [parameter, value] : parameters){
+        result += "/" + parameter + ":" + to_string(value);
+    }
+    return result;
+}
+
+/**
+ * Runs a benchmark whose every iteration is measured as a whole.
+ * @param name Name of the benchmark.
+ * @param parameters Names and values of the parameters of the benchmark.
+ * @param body Operation to be measured.
+ */
+void Benchmark::run(const string& name, const vector<pair<string, int>>& parameters, const function<void()>& body){
+    run(name, parameters, [](){}, body);
+}
+
+/**
+ * Runs a benchmark. The operation is run once without measurement to warm up the caches, then it is measured until both
+ * the minimum number of iterations and the minimum total time are reached. The set up before every iteration, such as
+ * loading a grammar which the operation changes, is not measured.
+ * @param name Name of the benchmark.
+ * @param parameters Names and values of the parameters of the benchmark.
+ * @param setUp Preparation of every iteration, not measured.
+ * @param body Operation to be measured.
+ */
+void Benchmark::run(const string& name, const vector<pair<string, int>>& parameters, const function<void()>& setUp, const function<void()>& body){
+    string benchmarkName = fullName(name, parameters);
+    if (!filter.empty() && benchmarkName.find(filter) == string::npos){
+        return;
+    }
+    BenchmarkResult result = {benchmarkName, parameters, {}, {}};
+    double total = 0.0;
+    setUp();
+    body();
+    while (result.realTimes.size() < minimumIterations || total < minimumTime * 1e9){
+        setUp();
+        clock_t cpuStart = clock();
+        auto start = chrono::steady_clock::now();
+        body();
+        auto end = chrono::steady_clock::now();
+        clock_t cpuEnd = clock();
+        result.realTimes.emplace_back(chrono::duration<double, nano>(end - start).count());
+        result.cpuTimes.emplace_back((cpuEnd - cpuStart) * 1e9 / CLOCKS_PER_SEC);
+        total += result.realTimes.back();
+    }
+    cerr << benchmarkName << ": " << total / result.realTimes.size() / 1e6 << " ms, " << result.realTimes.size() << " iterations" << endl;
+    results.emplace_back(result);
+}
+
+/**
+ * Writes a string as a JSON string literal.
+ * @param output Output stream.
+ * @param value String to be written.
+ */
+void Benchmark::writeString(ostream& output, const string& value){
+    output << '"';
+    for (char ch : value){
+        if (ch == '"' || ch == '\\'){
+            output << '\\';
+        }
+        output << ch;
+    }
+    output << '"';
+}
+
+/**
+ * Writes the results of all benchmarks run so far as JSON. Every benchmark has its name, its parameters, the number of
+ * measured iterations, and the mean wall clock and processor times with the median, minimum and maximum wall clock
+ * times per iteration, all in nanoseconds.
+ * @param output Output stream.
+ */
+void Benchmark::writeJson(ostream& output) const{
+    char date[32];
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+    output.precision(15);
+    output << "{\n  \"context\": {\n    \"date\": \"" << date << "\",\n    \"hardware_threads\": " << thread::hardware_concurrency() << "\n  },\n  \"benchmarks\": [";
+    for (int i = 0; i < results.size(); i++){
+        const BenchmarkResult& result = results[i];
+        vector<double> sorted = result.realTimes;
+        ranges::sort(sorted);
+        double realTime = accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+        double cpuTime = accumulate(result.cpuTimes.begin(), result.cpuTimes.end(), 0.0) / result.cpuTimes.size();
+        double median = sorted.size() % 2 == 1 ? sorted[sorted.size() / 2] : (sorted[sorted.size() / 2 - 1] + sorted[sorted.size() / 2]) / 2;
+        output << (i == 0 ? "\n" : ",\n") << "    {\n      \"name\": ";
+        writeString(output, result.name);
+        output << ",\n      \"parameters\": {";
+        for (int j = 0; j < result.parameters.size(); j++){
+            output << (j == 0 ? "" : ", ");
+            writeString(output, result.parameters[j].first);
+            output << ": " << result.parameters[j].second;
+        }
+        output << "},\n      \"iterations\": " << sorted.size();
+        output << ",\n      \"real_time\": " << realTime << ",\n      \"cpu_time\": " << cpuTime;
+        output << ",\n      \"median_real_time\": " << median << ",\n      \"min_real_time\": " << sorted.front() << ",\n      \"max_real_time\": " << sorted.back();
+        output << ",\n      \"time_unit\": \"ns\"\n    }";
+    }
+    output << "\n  ]\n}\n";
+}
@@ -0,0 +1,42 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#ifndef SYNTACTICPARSER_BENCHMARK_H
+#define SYNTACTICPARSER_BENCHMARK_H
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Timing of one benchmark: the wall clock and processor times of every measured iteration, in nanoseconds, together
+ * with the parameters the benchmark was run with.
+ */
+struct BenchmarkResult {
+    string name;
+    vector<pair<string, int>> parameters;
+    vector<double> realTimes;
+    vector<double> cpuTimes;
+};
+
+class Benchmark {
+private:
+    vector<BenchmarkResult> results;
+    double minimumTime;
+    int minimumIterations;
+    string filter;
+    static void writeString(ostream& output, const string& value);
+public:
+    Benchmark(double minimumTime, int minimumIterations, const string& filter);
+    [[nodiscard]] static string fullName(const string& name, const vector<pair<string, int>>& parameters);
+    void run(const string& name, const vector<pair<string, int>>& parameters, const function<void()>& body);
+    void run(const string& name, const vector<pair<string, int>>& parameters, const function<void()>& setUp, const function<void()>& body);
+    void writeJson(ostream& output) const;
+};
+
+
+#endif //SYNTACTICPARSER_BENCHMARK_H
@@ -0,0 +1,180 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include "Benchmark.h"
+#include "GrammarGenerator.h"
+#include "../SyntacticParser/CYKParser.h"
+#include "../ProbabilisticParser/ProbabilisticCYKParser.h"
+
+/**
+ * Treebank of the trees generated from a random grammar, which deletes its trees.
+ */
+class GeneratedTreeBank : public TreeBank {
+public:
+    GeneratedTreeBank(GrammarGenerator& generator, int treeCount, int minimumLength, int maximumLength){
+        for (int i = 0; i < treeCount; i++){
+            parseTrees.emplace_back(generator.generateTree(minimumLength + i % (maximumLength - minimumLength + 1)));
+        }
+    }
+    ~GeneratedTreeBank(){
+        for (ParseTree* parseTree : parseTrees){
+            delete parseTree;
+        }
+    }
+};
+
+/**
+ * Deletes the parse trees returned by a parser.
+ * @param parseTrees Parse trees to be deleted.
+ * @return Number of parse trees.
+ */
+static int deleteTrees(const vector<ParseTree*>& parseTrees){
+    for (ParseTree* parseTree : parseTrees){
+        delete parseTree;
+    }
+    return parseTrees.size();
+}
+
+/**
+ * Generates the given number of sentences of the given length from a generator.
+ * @param generator Generator of the grammar.
+ * @param count Number of sentences.
+ * @param length Number of words of every sentence.
+ * @return Generated sentences.
+ */
+static vector<vector<string>> generateSentences(GrammarGenerator& generator, int count, int length){
+    vector<vector<string>> sentences;
+    for (int i = 0; i < count; i++){
+        sentences.emplace_back(generator.generateSentence(length));
+    }
+    return sentences;
+}
+
+/**
+ * Runs the benchmarks of the library on random grammars, treebanks and sentences, which are generated from fixed seeds
+ * so that every run measures the same inputs, and writes the timings as JSON.
+ * Usage: benchmarks [--output file] [--min-time seconds] [--filter text] [--quick]
+ * --output writes the JSON into the file instead of the standard output, --min-time sets the minimum measured time of
+ * every benchmark (0.5 seconds by default), --filter runs only the benchmarks whose names contain the text, and
+ * --quick runs only the smallest sizes of every benchmark.
+ */
+int main(int argc, char** argv) {
+    double minimumTime = 0.5;
+    bool quick = false;
+    string outputFileName, filter;
+    for (int i = 1; i < argc; i++){
+        string argument = argv[i];
+        if (argument == "--quick"){
+            quick = true;
+        } else {
+            if (i + 1 < argc && (argument == "--output" || argument == "--min-time" || argument == "--filter")){
+                string value = argv[++i];
+                if (argument == "--output"){
+                    outputFileName = value;
+                } else {
+                    if (argument == "--min-time"){
+                        minimumTime = stod(value);
+                    } else {
+                        filter = value;
+                    }
+                }
+            } else {
+                cerr << "Usage: benchmarks [--output file] [--min-time seconds] [--filter text] [--quick]" << endl;
+                return 1;
+            }
+        }
+    }
+    Benchmark benchmark(minimumTime, 3, filter);
+    filesystem::path directory = filesystem::temp_directory_path() / "syntactic-parser-benchmarks";
+    filesystem::create_directories(directory);
+    string ruleFileName = (directory / "rules.txt").string(), dictionaryFileName = (directory / "dictionary.txt").string(), binaryFileName = (directory / "grammar.bin").string();
+    vector<int> grammarSizes = quick ? vector<int>{16} : vector<int>{16, 64, 256};
+    for (int nonTerminals : grammarSizes){
+        GrammarGenerator generator(1, nonTerminals, 20 * nonTerminals, 8, 2);
+        generator.writeGrammar(ruleFileName, dictionaryFileName, true);
+        benchmark.run("GrammarLoad/text", {{"nonTerminals", nonTerminals}, {"rules", generator.ruleCount()}}, [&](){
+            ProbabilisticContextFreeGrammar pCfg(ruleFileName, dictionaryFileName, 1);
+        });
+        ProbabilisticContextFreeGrammar(ruleFileName, dictionaryFileName, 1).saveBinary(binaryFileName);
+        benchmark.run("GrammarLoad/binary", {{"nonTerminals", nonTerminals}, {"rules", generator.ruleCount()}}, [&](){
+            ProbabilisticContextFreeGrammar pCfg(binaryFileName);
+        });
+    }
+    vector<int> normalFormSizes = quick ? vector<int>{16} : vector<int>{16, 32, 64};
+    for (int nonTerminals : normalFormSizes){
+        GrammarGenerator nonNormal(2, nonTerminals, 20 * nonTerminals, 8, 2, 2, 2);
+        nonNormal.writeGrammar(ruleFileName, dictionaryFileName, true);
+        unique_ptr<ProbabilisticContextFreeGrammar> grammar;
+        benchmark.run("ChomskyNormalForm", {{"nonTerminals", nonTerminals}, {"rules", nonNormal.ruleCount()}}, [&](){
+            grammar = make_unique<ProbabilisticContextFreeGrammar>(ruleFileName, dictionaryFileName, 1);
+        }, [&](){
+            grammar->convertToChomskyNormalForm();
+        });
+    }
+    vector<int> treeBankSizes = quick ? vector<int>{1000} : vector<int>{1000, 10000};
+    for (int trees : treeBankSizes){
+        GrammarGenerator generator(3, 64, 2000, 8, 2);
+        GeneratedTreeBank treeBank(generator, trees, 5, 30);
+        benchmark.run("TreebankInduction", {{"trees", trees}, {"threads", 1}}, [&](){
+            ProbabilisticContextFreeGrammar pCfg(treeBank, 1);
+        });
+        benchmark.run("TreebankInduction", {{"trees", trees}, {"threads", 0}}, [&](){
+            ProbabilisticContextFreeGrammar pCfg(treeBank, 1, 0);
+        });
+    }
+    vector<int> lengths = quick ? vector<int>{5} : vector<int>{5, 10, 15};
+    for (int length : lengths){
+        GrammarGenerator generator(4, 8, 40, 2, 1);
+        generator.writeGrammar(ruleFileName, dictionaryFileName, false);
+        ContextFreeGrammar cfg(ruleFileName, dictionaryFileName, 1);
+        cfg.convertToChomskyNormalForm();
+        vector<vector<string>> sentences = generateSentences(generator, 10, length);
+        CYKParser parser;
+        benchmark.run("CYKParser::parse", {{"length", length}, {"nonTerminals", 8}, {"binaryRules", 2}, {"tags", 1}}, [&](){
+            for (const vector<string>& sentence : sentences){
+                deleteTrees(parser.parse(cfg, sentence));
+            }
+        });
+    }
+    struct ParseSetting {
+        int length;
+        int nonTerminals;
+        int binaryRules;
+        int tags;
+    };
+    vector<ParseSetting> settings = quick ? vector<ParseSetting>{{10, 16, 4, 2}} : vector<ParseSetting>{
+        {5, 32, 8, 2}, {10, 32, 8, 2}, {20, 32, 8, 2}, {40, 32, 8, 2},
+        {20, 16, 8, 2}, {20, 64, 8, 2}, {20, 128, 8, 2},
+        {20, 32, 2, 2}, {20, 32, 32, 2},
+        {20, 32, 8, 1}, {20, 32, 8, 4}};
+    for (const ParseSetting& setting : settings){
+        GrammarGenerator generator(5, setting.nonTerminals, 20 * setting.nonTerminals, setting.binaryRules, setting.tags);
+        generator.writeGrammar(ruleFileName, dictionaryFileName, true);
+        ProbabilisticContextFreeGrammar pCfg(ruleFileName, dictionaryFileName, 1);
+        pCfg.convertToChomskyNormalForm();
+        vector<vector<string>> sentences = generateSentences(generator, 10, setting.length);
+        ProbabilisticCYKParser parser;
+        benchmark.run("ProbabilisticCYKParser::parse", {{"length", setting.length}, {"nonTerminals", setting.nonTerminals}, {"binaryRules", setting.binaryRules}, {"tags", setting.tags}}, [&](){
+            for (const vector<string>& sentence : sentences){
+                deleteTrees(parser.parse(pCfg, sentence));
+            }
+        });
+    }
+    filesystem::remove_all(directory);
+    if (outputFileName.empty()){
+        benchmark.writeJson(cout);
+    } else {
+        ofstream outputFile(outputFileName);
+        benchmark.writeJson(outputFile);
+        if (!outputFile.good()){
+            cerr << "Can not write " << outputFileName << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
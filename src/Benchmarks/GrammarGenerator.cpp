@@ -0,0 +1,204 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include <fstream>
+#include <set>
+#include "GrammarGenerator.h"
+
+/**
+ * Constructor for a generator of random grammars in Chomsky normal form. The grammar, and every tree and sentence
+ * generated from it afterwards, depends only on the seed and the parameters.
+ * @param seed Seed of the random number generator.
+ * @param nonTerminalCount Number of non-terminals, the start symbol S included.
+ * @param vocabularySize Number of words; at least the number of non-terminals, so that every non-terminal has a word.
+ * @param binaryRulesPerNonTerminal Number of rules X -> BC of every non-terminal X, the structural ambiguity.
+ * @param tagsPerWord Number of non-terminals deriving every word, the lexical ambiguity.
+ */
+GrammarGenerator::GrammarGenerator(unsigned int seed, int nonTerminalCount, int vocabularySize, int binaryRulesPerNonTerminal, int tagsPerWord) :
+        GrammarGenerator(seed, nonTerminalCount, vocabularySize, binaryRulesPerNonTerminal, tagsPerWord, 0, 0){
+}
+
+/**
+ * Constructor for a generator of random grammars, which are not in Chomsky normal form if they have unary or long
+ * rules. Trees and sentences are generated only with the binary and terminal rules, so that their lengths can be
+ * chosen exactly; the other rules only make the grammar larger and more ambiguous.
+ * @param seed Seed of the random number generator.
+ * @param nonTerminalCount Number of non-terminals, the start symbol S included.
+ * @param vocabularySize Number of words; at least the number of non-terminals, so that every non-terminal has a word.
+ * @param binaryRulesPerNonTerminal Number of rules X -> BC of every non-terminal X, the structural ambiguity.
+ * @param tagsPerWord Number of non-terminals deriving every word, the lexical ambiguity.
+ * @param unaryRulesPerNonTerminal Number of rules X -> Y of every non-terminal X.
+ * @param longRulesPerNonTerminal Number of rules of every non-terminal X with three or four symbols on the right hand
+ *                                side.
+ */
+GrammarGenerator::GrammarGenerator(unsigned int seed, int nonTerminalCount, int vocabularySize, int binaryRulesPerNonTerminal, int tagsPerWord, int unaryRulesPerNonTerminal, int longRulesPerNonTerminal) : random(seed){
+    int i, k, attempt;
+    set<pair<int, vector<int>>> added;
+    this->nonTerminalCount = max(1, nonTerminalCount);
+    this->vocabularySize = max(vocabularySize, this->nonTerminalCount);
+    binaryRules.resize(this->nonTerminalCount);
+    terminalRules.resize(this->nonTerminalCount);
+    auto addRule = [&](int leftHandSide, const vector<int>& rightHandSide, bool terminal){
+        if (!added.emplace(terminal ? -1 - leftHandSide : leftHandSide, rightHandSide).second){
+            return;
+        }
+        if (terminal){
+            terminalRules[leftHandSide].emplace_back(rules.size());
+        } else {
+            if (rightHandSide.size() == 2){
+                binaryRules[leftHandSide].emplace_back(rules.size());
+            }
+        }
+        rules.push_back({leftHandSide, rightHandSide, terminal, 0.0});
+    };
+    for (i = 0; i < this->nonTerminalCount; i++){
+        for (attempt = 0; binaryRules[i].size() < max(1, binaryRulesPerNonTerminal) && attempt < 100 * max(1, binaryRulesPerNonTerminal); attempt++){
+            addRule(i, {(int) (random() % this->nonTerminalCount), (int) (random() % this->nonTerminalCount)}, false);
+        }
+        for (k = 0; k < unaryRulesPerNonTerminal && this->nonTerminalCount > 1; k++){
+            addRule(i, {(int) ((i + 1 + random() % (this->nonTerminalCount - 1)) % this->nonTerminalCount)}, false);
+        }
+        for (k = 0; k < longRulesPerNonTerminal; k++){
+            vector<int> rightHandSide(3 + random() % 2);
+            for (int& symbol : rightHandSide){
+                symbol = random() % this->nonTerminalCount;
+            }
+            addRule(i, rightHandSide, false);
+        }
+    }
+    for (i = 0; i < this->vocabularySize; i++){
+        addRule(i % this->nonTerminalCount, {i}, true);
+        for (k = 1; k < tagsPerWord; k++){
+            addRule(random() % this->nonTerminalCount, {i}, true);
+        }
+    }
+    uniform_real_distribution<double> weight(0.1, 1.0);
+    vector<double> totals(this->nonTerminalCount, 0.0);
+    for (GeneratedRule& rule : rules){
+        rule.probability = weight(random);
+        totals[rule.leftHandSide] += rule.probability;
+    }
+    for (GeneratedRule& rule : rules){
+        rule.probability /= totals[rule.leftHandSide];
+    }
+}
+
+/**
+ * Returns the name of a non-terminal of the generated grammar.
+ * @param nonTerminal Index of the non-terminal.
+ * @return S for the first non-terminal, N1, N2, ... for the others.
+ */
+string GrammarGenerator::nonTerminalName(int nonTerminal) const{
+    return nonTerminal == 0 ? "S" : "N" + to_string(nonTerminal);
+}
+
+/**
+ * Returns the name of a word of the generated grammar.
+ * @param word Index of the word.
+ * @return w0, w1, ...
+ */
+string GrammarGenerator::wordName(int word){
+    return "w" + to_string(word);
+}
+
+/**
+ * Returns the number of rules of the generated grammar.
+ * @return Number of rules.
+ */
+int GrammarGenerator::ruleCount() const{
+    return rules.size();
+}
+
+/**
+ * Writes the generated grammar in the text formats read by the grammar constructors: one rule X -> ... per line in
+ * the rule file, with its probability in brackets for a probabilistic grammar, and every word with its count in the
+ * dictionary file.
+ * @param ruleFileName File name for the rule file.
+ * @param dictionaryFileName File name for the dictionary file.
+ * @param probabilistic If true, the probabilities of the rules are written.
+ * @return True if both files are written, false otherwise.
+ */
+bool GrammarGenerator::writeGrammar(const string& ruleFileName, const string& dictionaryFileName, bool probabilistic) const{
+    ofstream ruleFile(ruleFileName), dictionaryFile(dictionaryFileName);
+    if (!ruleFile.is_open() || !dictionaryFile.is_open()){
+        return false;
+    }
+    ruleFile.precision(12);
+    for (const GeneratedRule& rule : rules){
+        ruleFile << nonTerminalName(rule.leftHandSide) << " ->";
+        for (int symbol : rule.rightHandSide){
+            ruleFile << " " << (rule.terminal ? wordName(symbol) : nonTerminalName(symbol));
+        }
+        if (probabilistic){
+            ruleFile << " [" << rule.probability << "]";
+        }
+        ruleFile << "\n";
+    }
+    for (int i = 0; i < vocabularySize; i++){
+        dictionaryFile << wordName(i) << " 10\n";
+    }
+    return ruleFile.good() && dictionaryFile.good();
+}
+
+/**
+ * Picks one of the given rules randomly in proportion to their probabilities.
+ * @param candidates Indexes of the rules.
+ * @return Index of the picked rule.
+ */
+int GrammarGenerator::pick(const vector<int>& candidates){
+    double total = 0.0;
+    for (int index : candidates){
+        total += rules[index].probability;
+    }
+    double value = uniform_real_distribution<double>(0.0, total)(random);
+    for (int index : candidates){
+        value -= rules[index].probability;
+        if (value <= 0.0){
+            return index;
+        }
+    }
+    return candidates.back();
+}
+
+/**
+ * Generates a random subtree of the given non-terminal over exactly the given number of words. A single word is
+ * derived with a terminal rule; a longer span with a binary rule and a uniformly chosen split point.
+ * @param nonTerminal Index of the non-terminal at the root of the subtree.
+ * @param length Number of words of the subtree.
+ * @param words Output, the words of the subtree are appended.
+ * @return Root of the subtree.
+ */
+ParseNode* GrammarGenerator::generateNode(int nonTerminal, int length, vector<string>& words){
+    if (length == 1){
+        const GeneratedRule& rule = rules[pick(terminalRules[nonTerminal])];
+        words.emplace_back(wordName(rule.rightHandSide[0]));
+        return new ParseNode(new ParseNode(Symbol(words.back())), Symbol(nonTerminalName(nonTerminal)));
+    }
+    const GeneratedRule& rule = rules[pick(binaryRules[nonTerminal])];
+    int split = 1 + random() % (length - 1);
+    ParseNode* left = generateNode(rule.rightHandSide[0], split, words);
+    ParseNode* right = generateNode(rule.rightHandSide[1], length - split, words);
+    return new ParseNode(left, right, Symbol(nonTerminalName(nonTerminal)));
+}
+
+/**
+ * Generates a random tree of the start symbol S over exactly the given number of words.
+ * @param length Number of words, at least 1.
+ * @return Generated tree.
+ */
+ParseTree* GrammarGenerator::generateTree(int length){
+    vector<string> words;
+    return new ParseTree(generateNode(0, max(1, length), words));
+}
+
+/**
+ * Generates a random sentence of exactly the given number of words, which the generated grammar can parse.
+ * @param length Number of words, at least 1.
+ * @return Words of the sentence.
+ */
+vector<string> GrammarGenerator::generateSentence(int length){
+    vector<string> words;
+    delete generateNode(0, max(1, length), words);
+    return words;
+}
@@ -0,0 +1,48 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#ifndef SYNTACTICPARSER_GRAMMARGENERATOR_H
+#define SYNTACTICPARSER_GRAMMARGENERATOR_H
+
+#include <random>
+#include <string>
+#include <vector>
+#include "ParseTree.h"
+
+using namespace std;
+
+/**
+ * Rule of a generated grammar, given by the indexes of its symbols. Non-terminals and words have separate indexes;
+ * a terminal rule X -> w has the single word w on its right hand side.
+ */
+struct GeneratedRule {
+    int leftHandSide;
+    vector<int> rightHandSide;
+    bool terminal;
+    double probability;
+};
+
+class GrammarGenerator {
+private:
+    mt19937 random;
+    int nonTerminalCount;
+    int vocabularySize;
+    vector<GeneratedRule> rules;
+    vector<vector<int>> binaryRules;
+    vector<vector<int>> terminalRules;
+    [[nodiscard]] string nonTerminalName(int nonTerminal) const;
+    [[nodiscard]] static string wordName(int word);
+    int pick(const vector<int>& candidates);
+    ParseNode* generateNode(int nonTerminal, int length, vector<string>& words);
+public:
+    GrammarGenerator(unsigned int seed, int nonTerminalCount, int vocabularySize, int binaryRulesPerNonTerminal, int tagsPerWord);
+    GrammarGenerator(unsigned int seed, int nonTerminalCount, int vocabularySize, int binaryRulesPerNonTerminal, int tagsPerWord, int unaryRulesPerNonTerminal, int longRulesPerNonTerminal);
+    [[nodiscard]] int ruleCount() const;
+    bool writeGrammar(const string& ruleFileName, const string& dictionaryFileName, bool probabilistic) const;
+    ParseTree* generateTree(int length);
+    vector<string> generateSentence(int length);
+};
+
+
+#endif //SYNTACTICPARSER_GRAMMARGENERATOR_H
@@ -2,11 +2,23 @@
 // Created by Olcay Taner YILDIZ on 14.02.2024.
 //
 
-#include <regex>
 #include "ContextFreeGrammar.h"
 #include <StringUtils.h>
 #include "NodeCollector.h"
 #include "NodeCondition/IsLeaf.h"
+#include "GrammarFile.h"
+#include "../SyntacticParser/WorkStealingPool.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <queue>
+#include <set>
+#include <stdexcept>
+#include <tuple>
 #include <unordered_set>
 
 using namespace std;
@@ -23,6 +35,9 @@ void ContextFreeGrammar::readDictionary(const string& dictionaryFileName) {
     while (inputFile.good()) {
         getline(inputFile, line);
         vector<string> items = StringUtils::split(line);
+        if (items.size() < 2){
+            continue;
+        }
         dictionary.putNTimes(items[0], stoi(items[1]));
     }
     inputFile.close();
@@ -32,11 +47,11 @@ void ContextFreeGrammar::readDictionary(const string& dictionaryFileName) {
  * Compares two rules based on their left sides lexicographically.
  * @param ruleA the first rule to be compared.
  * @param ruleB the second rule to be compared.
- * @return -1 if the first rule is less than the second rule lexicographically, 1 if the first rule is larger than
- *          the second rule lexicographically, 0 if they are the same rule.
+ * @return True if the left side of the first rule is less than the left side of the second rule lexicographically,
+ *          false otherwise.
  */
 bool ContextFreeGrammar::compareRuleLeft(const Rule* ruleA, const Rule* ruleB){
-    return ruleA->getLeftHandSide().getName() <= ruleB->getLeftHandSide().getName();
+    return ruleA->getLeftHandSide().getName() < ruleB->getLeftHandSide().getName();
 }
 
 int ContextFreeGrammar::compareRuleLeft3Way(const Rule* ruleA, const Rule* ruleB) {
@@ -55,23 +70,11 @@ int ContextFreeGrammar::compareRuleLeft3Way(const Rule* ruleA, const Rule* ruleB
  * Compares two rules based on their right sides lexicographically.
  * @param ruleA the first rule to be compared.
  * @param ruleB the second rule to be compared.
- * @return -1 if the first rule is less than the second rule lexicographically, 1 if the first rule is larger than
- *          the second rule lexicographically, 0 if they are the same rule.
+ * @return True if the right side of the first rule is less than the right side of the second rule
+ *          lexicographically, false otherwise.
  */
 bool ContextFreeGrammar::compareRuleRight(const Rule* ruleA, const Rule* ruleB) {
-    int i = 0;
-    while (i < ruleA->getRightHandSideSize() && i < ruleB->getRightHandSideSize()){
-        if (ruleA->getRightHandSideAt(i) == ruleB->getRightHandSideAt(i)){
-            i++;
-        } else {
-            return ruleA->getRightHandSideAt(i) == ruleB->getRightHandSideAt(i);
-        }
-    }
-    if (ruleA->getRightHandSideSize() <= ruleB->getRightHandSideSize()){
-        return true;
-    } else {
-        return false;
-    }
+    return compareRuleRight3Way(ruleA, ruleB) < 0;
 }
 
 int ContextFreeGrammar::compareRuleRight3Way(const Rule* ruleA, const Rule* ruleB) {
@@ -117,6 +120,9 @@ ContextFreeGrammar::ContextFreeGrammar(const string &ruleFileName,
     inputFile.open(ruleFileName, ifstream :: in);
     while (inputFile.good()) {
         getline(inputFile, line);
+        if (line.find("->") == string::npos){
+            continue;
+        }
         Rule* newRule = new Rule(line);
         rules.emplace_back(newRule);
         rulesRightSorted.emplace_back(newRule);
@@ -126,6 +132,8 @@ ContextFreeGrammar::ContextFreeGrammar(const string &ruleFileName,
     ranges::sort(rulesRightSorted, compareRuleRight);
     readDictionary(dictionaryFileName);
     updateTypes();
+    updateSymbolIds();
+    updateRuleIndex();
     this->minCount = minCount;
 }
 
@@ -137,16 +145,68 @@ ContextFreeGrammar::ContextFreeGrammar(const string &ruleFileName,
  * @param minCount Minimum frequency parameter.
  */
 ContextFreeGrammar::ContextFreeGrammar(const TreeBank& treeBank, int minCount){
+    RuleSet inducedRules;
     constructDictionary(treeBank);
     for (int i = 0; i < treeBank.size(); i++){
         ParseTree* parseTree = treeBank.get(i);
         updateTree(parseTree, minCount);
-        addRules(parseTree->getRoot());
+        addRules(parseTree->getRoot(), inducedRules);
+    }
+    setRules(vector<Rule*>(inducedRules.begin(), inducedRules.end()));
+    updateTypes();
+    updateSymbolIds();
+    updateRuleIndex();
+    this->minCount = minCount;
+}
+
+/**
+ * Another constructor for the ContextFreeGrammar class. Induces the same grammar as the serial treebank constructor
+ * with a pool of threads: the treebank is split into contiguous shards, every shard builds its own lexicon and its
+ * own set of distinct rules, and the shards are merged in shard order.
+ * @param treeBank Treebank containing the constituency trees.
+ * @param minCount Minimum frequency parameter.
+ * @param threadCount Number of threads. If it is not positive, the number of hardware threads is used.
+ */
+ContextFreeGrammar::ContextFreeGrammar(const TreeBank &treeBank, int minCount, int threadCount) {
+    WorkStealingPool pool(threadCount);
+    constructDictionary(treeBank, pool);
+    int shards = shardCount(treeBank, pool);
+    vector<RuleSet> shardRules(shards);
+    pool.parallelFor(shards, [&](int shard, int worker){
+        auto [first, last] = shardRange(treeBank, shards, shard);
+        for (int i = first; i < last; i++){
+            ParseTree* parseTree = treeBank.get(i);
+            updateTree(parseTree, minCount);
+            addRules(parseTree->getRoot(), shardRules[shard]);
+        }
+    });
+    RuleSet inducedRules;
+    for (const RuleSet& ruleSet : shardRules){
+        for (Rule* rule : ruleSet){
+            if (!inducedRules.emplace(rule).second){
+                delete rule;
+            }
+        }
     }
+    setRules(vector<Rule*>(inducedRules.begin(), inducedRules.end()));
     updateTypes();
+    updateSymbolIds();
+    updateRuleIndex();
     this->minCount = minCount;
 }
 
+/**
+ * Another constructor for the ContextFreeGrammar class. Loads a grammar compiled with saveBinary from a
+ * non-probabilistic grammar.
+ * @param binaryFileName File name of the compiled grammar.
+ * @throws invalid_argument If the file can not be read, or is not a valid compiled non-probabilistic grammar.
+ */
+ContextFreeGrammar::ContextFreeGrammar(const string &binaryFileName) {
+    if (!loadBinary(binaryFileName)){
+        throw invalid_argument("Can not load the compiled grammar " + binaryFileName);
+    }
+}
+
 /**
  * Updates the types of the rules according to the number of symbols on the right hand side. Rule type is TERMINAL
  * if the rule is like X -> a, SINGLE_NON_TERMINAL if the rule is like X -> Y, TWO_NON_TERMINAL if the rule is like
@@ -174,6 +234,677 @@ void ContextFreeGrammar::updateTypes() const {
     }
 }
 
+/**
+ * Assigns a compact integer id to every symbol in the grammar and stores the ids in the rules. Non-terminal symbols,
+ * i.e. the symbols on the left hand side of the rules, get the dense ids 0, 1, ..., nonTerminalCount - 1, so that they
+ * can index arrays directly; the remaining symbols on the right hand sides (terminals) get the following ids. The
+ * method should be called again whenever the rules of the grammar change.
+ */
+void ContextFreeGrammar::updateSymbolIds() {
+    symbolIds.clear();
+    symbols.clear();
+    for (const Rule* rule : rules){
+        if (symbolIds.emplace(rule->getLeftHandSide().getName(), symbols.size()).second){
+            symbols.emplace_back(rule->getLeftHandSide());
+        }
+    }
+    nonTerminalCount = symbols.size();
+    for (const Rule* rule : rules){
+        for (const Symbol& symbol : rule->getRightHandSide()){
+            if (symbolIds.emplace(symbol.getName(), symbols.size()).second){
+                symbols.emplace_back(symbol);
+            }
+        }
+    }
+    for (Rule* rule : rules){
+        vector<int> rightHandSideIds;
+        for (const Symbol& symbol : rule->getRightHandSide()){
+            rightHandSideIds.emplace_back(symbolIds[symbol.getName()]);
+        }
+        rule->setSymbolIds(symbolIds[rule->getLeftHandSide().getName()], rightHandSideIds);
+    }
+    startSymbolId = getSymbolId("S");
+}
+
+/**
+ * Returns the key of the pair of symbols B and C in the binary rule index.
+ * @param B Id of the first symbol on the right hand side.
+ * @param C Id of the second symbol on the right hand side.
+ * @return Key of the pair (B, C).
+ */
+static long long binaryRuleKey(int B, int C){
+    return ((long long) B << 32) | (unsigned int) C;
+}
+
+/**
+ * Builds the lookup indexes used by the parsers from the symbol ids of the rules. Rules such as X -> BC are stored
+ * contiguously in binaryRules, grouped by their right hand side, and binaryRuleIndex maps every pair (B, C) to the
+ * range of its rules. Similarly, terminal rules such as X -> a are grouped by their terminal symbol a, and
+ * terminalRuleOffsets gives the range of the rules of every symbol. The method should be called after
+ * updateSymbolIds.
+ */
+void ContextFreeGrammar::updateRuleIndex() {
+    binaryRules.clear();
+    terminalRules.clear();
+    terminalRuleOffsets.assign(symbols.size() + 1, 0);
+    for (Rule* rule : rules){
+        if (rule->getRightHandSideSize() == 2){
+            binaryRules.emplace_back(rule);
+        } else {
+            if (rule->getRuleType() == RuleType::TERMINAL){
+                terminalRules.emplace_back(rule);
+                terminalRuleOffsets[rule->getRightHandSideIdAt(0) + 1]++;
+            }
+        }
+    }
+    ranges::sort(binaryRules, [](const Rule* ruleA, const Rule* ruleB){
+        if (ruleA->getRightHandSideIdAt(0) != ruleB->getRightHandSideIdAt(0)){
+            return ruleA->getRightHandSideIdAt(0) < ruleB->getRightHandSideIdAt(0);
+        }
+        if (ruleA->getRightHandSideIdAt(1) != ruleB->getRightHandSideIdAt(1)){
+            return ruleA->getRightHandSideIdAt(1) < ruleB->getRightHandSideIdAt(1);
+        }
+        return ruleA->getLeftHandSideId() < ruleB->getLeftHandSideId();
+    });
+    ranges::stable_sort(terminalRules, [](const Rule* ruleA, const Rule* ruleB){
+        return ruleA->getRightHandSideIdAt(0) < ruleB->getRightHandSideIdAt(0);
+    });
+    for (int i = 1; i < terminalRuleOffsets.size(); i++){
+        terminalRuleOffsets[i] += terminalRuleOffsets[i - 1];
+    }
+    updateRuleLookups();
+}
+
+/**
+ * Builds the hash based lookups from the sorted binaryRules array: binaryRuleIndex maps every pair (B, C) to the
+ * range of its rules. It also computes the unary closure and the left corner index of the non-terminals, and checks if
+ * the grammar still has rules with more than two symbols on the right hand side. Unlike updateRuleIndex, the method
+ * does not sort, so it is also used after loading a compiled grammar, whose rule arrays are stored already sorted.
+ * Subclasses override it to build their own lookups.
+ */
+void ContextFreeGrammar::updateRuleLookups() {
+    multipleNonTerminalRules = ranges::any_of(rules, [](const Rule* rule){ return rule->getRightHandSideSize() > 2; });
+    updateUnaryClosure();
+    updateLeftCornerIndex();
+    binaryRuleIndex.clear();
+    int start = 0;
+    for (int i = 1; i <= binaryRules.size(); i++){
+        if (i == binaryRules.size() || binaryRules[i]->getRightHandSideIdAt(0) != binaryRules[start]->getRightHandSideIdAt(0) || binaryRules[i]->getRightHandSideIdAt(1) != binaryRules[start]->getRightHandSideIdAt(1)){
+            binaryRuleIndex.emplace(binaryRuleKey(binaryRules[start]->getRightHandSideIdAt(0), binaryRules[start]->getRightHandSideIdAt(1)), make_pair(start, i));
+            start = i;
+        }
+    }
+}
+
+/**
+ * Creates a rule of this grammar while loading a compiled grammar or converting the grammar into Chomsky normal form.
+ * Probabilistic grammars override it to create probabilistic rules.
+ * @param leftHandSide Left hand side symbol of the rule.
+ * @param rightHandSide Right hand side symbols of the rule.
+ * @param type Type of the rule.
+ * @param probability Probability of the rule, not used in a non-probabilistic grammar.
+ * @return New rule.
+ */
+Rule *ContextFreeGrammar::createRule(const Symbol &leftHandSide, const vector<Symbol> &rightHandSide, RuleType type, double probability) const {
+    return new Rule(leftHandSide, rightHandSide, type);
+}
+
+/**
+ * Returns the probability of a rule of this grammar to be stored in a compiled grammar.
+ * @param rule Rule of the grammar.
+ * @return 0 in a non-probabilistic grammar.
+ */
+double ContextFreeGrammar::ruleProbability(const Rule *rule) const {
+    return 0;
+}
+
+/**
+ * Returns the log probability of a rule of this grammar, used in choosing the best chains of the unary closure.
+ * @param rule Rule of the grammar.
+ * @return 0 in a non-probabilistic grammar, so that the shortest chains are chosen.
+ */
+double ContextFreeGrammar::ruleLogProbability(const Rule *rule) const {
+    return 0;
+}
+
+/**
+ * Checks if the grammar is probabilistic, which is stored in the header of a compiled grammar, so that a compiled
+ * grammar is loaded only by a grammar of the same kind. Probabilistic grammars override it.
+ * @return False in a non-probabilistic grammar.
+ */
+bool ContextFreeGrammar::isProbabilistic() const {
+    return false;
+}
+
+/**
+ * Computes the unary closure of every non-terminal Y: for every non-terminal X deriving Y with a chain of unary rules
+ * such as X -> Z, Z -> Y, the chain with the best log probability, and among those the shortest one. The chains are
+ * found with Dijkstra's algorithm on the unary rules upwards from Y, so the entry of Z is stored before the entries
+ * of the chains continuing above Z. Rules such as X -> X never improve a chain and are skipped. The closure is empty
+ * if the grammar has no unary rules, e.g. after converting it into Chomsky normal form.
+ */
+void ContextFreeGrammar::updateUnaryClosure() {
+    vector<vector<Rule*>> unaryParents(nonTerminalCount);
+    unaryClosure.clear();
+    unaryClosureOffsets.assign(nonTerminalCount + 1, 0);
+    for (Rule* rule : rules){
+        if (rule->getRuleType() == RuleType::SINGLE_NON_TERMINAL && !rule->leftRecursive() && rule->getLeftHandSideId() < nonTerminalCount && rule->getRightHandSideIdAt(0) < nonTerminalCount){
+            unaryParents[rule->getRightHandSideIdAt(0)].emplace_back(rule);
+        }
+    }
+    vector<double> scores(nonTerminalCount, -numeric_limits<double>::infinity());
+    vector<int> lengths(nonTerminalCount, 0), entries(nonTerminalCount, -1);
+    vector<Rule*> chainRules(nonTerminalCount, nullptr);
+    vector<int> visited;
+    priority_queue<tuple<double, int, int>> queue;
+    for (int symbolId = 0; symbolId < nonTerminalCount; symbolId++){
+        unaryClosureOffsets[symbolId] = unaryClosure.size();
+        if (unaryParents[symbolId].empty()){
+            continue;
+        }
+        scores[symbolId] = 0;
+        visited.emplace_back(symbolId);
+        queue.emplace(0.0, 0, symbolId);
+        while (!queue.empty()){
+            auto [score, negativeLength, current] = queue.top();
+            queue.pop();
+            if (entries[current] != -1){
+                continue;
+            }
+            if (current != symbolId){
+                int child = chainRules[current]->getRightHandSideIdAt(0);
+                entries[current] = unaryClosure.size();
+                unaryClosure.push_back({current, child == symbolId ? -1 : entries[child], chainRules[current], score});
+            }
+            for (Rule* rule : unaryParents[current]){
+                int parent = rule->getLeftHandSideId(), length = 1 - negativeLength;
+                double parentScore = score + ruleLogProbability(rule);
+                if (parent == symbolId || entries[parent] != -1){
+                    continue;
+                }
+                if (parentScore > scores[parent] || (parentScore == scores[parent] && length < lengths[parent])){
+                    if (scores[parent] == -numeric_limits<double>::infinity()){
+                        visited.emplace_back(parent);
+                    }
+                    scores[parent] = parentScore;
+                    lengths[parent] = length;
+                    chainRules[parent] = rule;
+                    queue.emplace(parentScore, -length, parent);
+                }
+            }
+        }
+        for (int symbol : visited){
+            scores[symbol] = -numeric_limits<double>::infinity();
+            entries[symbol] = -1;
+        }
+        visited.clear();
+    }
+    unaryClosureOffsets[nonTerminalCount] = unaryClosure.size();
+}
+
+/**
+ * Checks if the grammar keeps unary rules such as X -> Y, which the parsers apply with the unary closure.
+ * @return True if the grammar contains unary rules between different non-terminals, false otherwise.
+ */
+bool ContextFreeGrammar::hasUnaryRules() const{
+    return !unaryClosure.empty();
+}
+
+/**
+ * Checks if the grammar has rules such as X -> YZT... with more than two symbols on the right hand side, that is, if
+ * it is not binarized by convertToChomskyNormalForm.
+ * @return True if the grammar contains rules with more than two symbols on the right hand side, false otherwise.
+ */
+bool ContextFreeGrammar::hasMultipleNonTerminalRules() const{
+    return multipleNonTerminalRules;
+}
+
+/**
+ * Returns the range of the unary closure entries of a non-terminal Y, that is, of the best chains of unary rules
+ * X -> ... -> Y deriving it. The entry of a chain is stored after the entry of the chain below it.
+ * @param symbolId Id of the non-terminal Y.
+ * @return Start (inclusive) and end (exclusive) positions of the entries, an empty range if there is no such chain.
+ */
+pair<int, int> ContextFreeGrammar::getUnaryClosureRange(int symbolId) const{
+    if (symbolId < 0 || symbolId + 1 >= unaryClosureOffsets.size()){
+        return make_pair(0, 0);
+    }
+    return make_pair(unaryClosureOffsets[symbolId], unaryClosureOffsets[symbolId + 1]);
+}
+
+/**
+ * Returns the unary closure entry at the given position.
+ * @param index Position of the entry, obtained from getUnaryClosureRange.
+ * @return Unary closure entry at the given position.
+ */
+const UnaryClosureEntry& ContextFreeGrammar::getUnaryClosureEntry(int index) const{
+    return unaryClosure[index];
+}
+
+/**
+ * Builds the left corner index used by the Earley parser. Rules with two or more symbols on the right hand side, such
+ * as X -> YZT, are grouped by their first symbol Y, the left corner of the rule. For every non-terminal X, the left
+ * corner closure lists the other non-terminals Y which can start a derivation of X, i.e. X -> Y..., X -> Z... and
+ * Z -> Y..., and so on, following both the rules with many symbols and the unary rules.
+ */
+void ContextFreeGrammar::updateLeftCornerIndex() {
+    vector<vector<int>> firstChildren(nonTerminalCount);
+    leftCornerRules.clear();
+    leftCornerRuleOffsets.assign(nonTerminalCount + 1, 0);
+    for (Rule* rule : rules){
+        if (rule->getRuleType() == RuleType::TERMINAL || rule->getLeftHandSideId() >= nonTerminalCount || rule->getRightHandSideIdAt(0) >= nonTerminalCount){
+            continue;
+        }
+        firstChildren[rule->getLeftHandSideId()].emplace_back(rule->getRightHandSideIdAt(0));
+        if (rule->getRightHandSideSize() > 1){
+            leftCornerRules.emplace_back(rule);
+            leftCornerRuleOffsets[rule->getRightHandSideIdAt(0) + 1]++;
+        }
+    }
+    ranges::stable_sort(leftCornerRules, [](const Rule* ruleA, const Rule* ruleB){
+        return ruleA->getRightHandSideIdAt(0) < ruleB->getRightHandSideIdAt(0);
+    });
+    for (int i = 1; i < leftCornerRuleOffsets.size(); i++){
+        leftCornerRuleOffsets[i] += leftCornerRuleOffsets[i - 1];
+    }
+    leftCorners.clear();
+    leftCornerOffsets.assign(nonTerminalCount + 1, 0);
+    vector<char> reached(nonTerminalCount, 0);
+    for (int symbolId = 0; symbolId < nonTerminalCount; symbolId++){
+        int start = leftCorners.size();
+        leftCornerOffsets[symbolId] = start;
+        reached[symbolId] = 1;
+        for (int current = symbolId, next = start; ; current = leftCorners[next++]){
+            for (int child : firstChildren[current]){
+                if (!reached[child]){
+                    reached[child] = 1;
+                    leftCorners.emplace_back(child);
+                }
+            }
+            if (next == leftCorners.size()){
+                break;
+            }
+        }
+        reached[symbolId] = 0;
+        for (int i = start; i < leftCorners.size(); i++){
+            reached[leftCorners[i]] = 0;
+        }
+    }
+    leftCornerOffsets[nonTerminalCount] = leftCorners.size();
+}
+
+/**
+ * Returns the range of the rules with two or more symbols on the right hand side whose first symbol is the given
+ * non-terminal. The positions in the range can be passed to getLeftCornerRule and serve as compact ids of the rules.
+ * @param symbolId Id of the non-terminal Y.
+ * @return Start (inclusive) and end (exclusive) positions of the rules such as X -> Y..., an empty range if there is
+ * no such rule.
+ */
+pair<int, int> ContextFreeGrammar::getLeftCornerRuleRange(int symbolId) const{
+    if (symbolId < 0 || symbolId + 1 >= leftCornerRuleOffsets.size()){
+        return make_pair(0, 0);
+    }
+    return make_pair(leftCornerRuleOffsets[symbolId], leftCornerRuleOffsets[symbolId + 1]);
+}
+
+/**
+ * Returns the rule at the given position of the left corner index.
+ * @param index Position of the rule, obtained from getLeftCornerRuleRange.
+ * @return Rule at the given position.
+ */
+Rule* ContextFreeGrammar::getLeftCornerRule(int index) const{
+    return leftCornerRules[index];
+}
+
+/**
+ * Returns the left corner closure of a non-terminal X, the other non-terminals which can be the first symbol of a
+ * derivation of X.
+ * @param symbolId Id of the non-terminal X.
+ * @return Ids of the non-terminals in the left corner closure of X, an empty span if there is none.
+ */
+span<const int> ContextFreeGrammar::getLeftCornerClosure(int symbolId) const{
+    if (symbolId < 0 || symbolId + 1 >= leftCornerOffsets.size()){
+        return {};
+    }
+    return span<const int>(leftCorners.data() + leftCornerOffsets[symbolId], leftCornerOffsets[symbolId + 1] - leftCornerOffsets[symbolId]);
+}
+
+/**
+ * Writes the given section of a compiled grammar, padded to a multiple of 8 bytes.
+ * @param outputFile Output file.
+ * @param section Section to be written.
+ */
+template <class T> static void writeSection(ofstream& outputFile, const vector<T>& section){
+    static const char padding[8] = {};
+    outputFile.write((const char*) section.data(), section.size() * sizeof(T));
+    outputFile.write(padding, (8 - section.size() * sizeof(T) % 8) % 8);
+}
+
+/**
+ * Returns the section of a compiled grammar starting at the given offset, and moves the offset past the section and
+ * its padding.
+ * @param data Contents of the compiled grammar.
+ * @param size Size of the compiled grammar in bytes.
+ * @param offset Offset of the section, updated to the offset of the next section.
+ * @param count Number of items in the section.
+ * @return Pointer to the first item of the section, null if the section does not fit in the file.
+ */
+template <class T> static const T* readSection(const char* data, size_t size, size_t& offset, int64_t count){
+    if (offset > size || (uint64_t) count > (size - offset) / sizeof(T)){
+        offset = size + 1;
+        return nullptr;
+    }
+    const T* section = (const T*) (data + offset);
+    offset += (count * sizeof(T) + 7) / 8 * 8;
+    return section;
+}
+
+/**
+ * Checks the offsets section of a compiled grammar: the offsets must not decrease, and they must lie between the
+ * given bounds.
+ * @param offsets Offsets section with count + 1 items.
+ * @param count Number of ranges the offsets delimit.
+ * @param first Smallest valid offset.
+ * @param last Largest valid offset.
+ * @return True if the offsets are valid, false otherwise.
+ */
+template <class T> static bool validOffsets(const T* offsets, int64_t count, int64_t first, int64_t last){
+    if (offsets[0] < first || offsets[count] > last){
+        return false;
+    }
+    for (int64_t i = 0; i < count; i++){
+        if (offsets[i] > offsets[i + 1]){
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Checks an order section of a compiled grammar: every item must be the index of a rule of the given type, and no
+ * rule may occur twice.
+ * @param order Order section.
+ * @param count Number of items in the section.
+ * @param types Rule types section.
+ * @param ruleCount Number of rules.
+ * @param type Type of the rules in the section, -1 if the section may hold rules of any type.
+ * @return True if the order is valid, false otherwise.
+ */
+static bool validOrder(const int* order, int64_t count, const int* types, int64_t ruleCount, int type){
+    vector<bool> listed(ruleCount, false);
+    for (int64_t i = 0; i < count; i++){
+        if (order[i] < 0 || order[i] >= ruleCount || listed[order[i]] || (type >= 0 && types[order[i]] != type)){
+            return false;
+        }
+        listed[order[i]] = true;
+    }
+    return true;
+}
+
+/**
+ * Writes the grammar in the compiled binary format described in GrammarFileHeader. The file holds the symbol table,
+ * the rules with their symbol ids, the sorted rule arrays used by the parsers and the lexicon, so that loading it
+ * needs neither parsing the text files nor sorting the rules.
+ * @param binaryFileName File name of the compiled grammar.
+ * @return True if the file is written, false otherwise.
+ */
+bool ContextFreeGrammar::saveBinary(const string &binaryFileName) const {
+    unordered_map<const Rule*, int> ruleIndexes;
+    for (int i = 0; i < rules.size(); i++){
+        if (!rules[i]->hasSymbolIds()){
+            return false;
+        }
+        ruleIndexes.emplace(rules[i], i);
+    }
+    string stringPool;
+    vector<int64_t> symbolOffsets, dictionaryOffsets;
+    vector<int> dictionaryCounts;
+    for (const Symbol& symbol : symbols){
+        symbolOffsets.emplace_back(stringPool.size());
+        stringPool += symbol.getName();
+    }
+    symbolOffsets.emplace_back(stringPool.size());
+    for (const auto& [word, count] : dictionary){
+        dictionaryOffsets.emplace_back(stringPool.size());
+        dictionaryCounts.emplace_back(count);
+        stringPool += word;
+    }
+    dictionaryOffsets.emplace_back(stringPool.size());
+    vector<int> leftHandSides, types, rightHandSideOffsets, rightHandSideIds;
+    vector<double> probabilities;
+    for (const Rule* rule : rules){
+        leftHandSides.emplace_back(rule->getLeftHandSideId());
+        types.emplace_back((int) rule->getRuleType());
+        rightHandSideOffsets.emplace_back(rightHandSideIds.size());
+        for (int i = 0; i < rule->getRightHandSideSize(); i++){
+            rightHandSideIds.emplace_back(rule->getRightHandSideIdAt(i));
+        }
+        probabilities.emplace_back(ruleProbability(rule));
+    }
+    rightHandSideOffsets.emplace_back(rightHandSideIds.size());
+    vector<int> rightSortedOrder, binaryOrder, terminalOrder;
+    for (const Rule* rule : rulesRightSorted){
+        rightSortedOrder.emplace_back(ruleIndexes.at(rule));
+    }
+    for (const Rule* rule : binaryRules){
+        binaryOrder.emplace_back(ruleIndexes.at(rule));
+    }
+    for (const Rule* rule : terminalRules){
+        terminalOrder.emplace_back(ruleIndexes.at(rule));
+    }
+    vector<int> terminalOffsets = terminalRuleOffsets;
+    if (terminalOffsets.empty()){
+        terminalOffsets.assign(symbols.size() + 1, 0);
+    }
+    GrammarFileHeader header{};
+    copy(begin(GRAMMAR_FILE_MAGIC), end(GRAMMAR_FILE_MAGIC), header.magic);
+    header.version = GRAMMAR_FILE_VERSION;
+    header.probabilistic = isProbabilistic();
+    header.minCount = minCount;
+    header.symbolCount = symbols.size();
+    header.nonTerminalCount = nonTerminalCount;
+    header.startSymbolId = startSymbolId;
+    header.ruleCount = rules.size();
+    header.rightHandSideIdCount = rightHandSideIds.size();
+    header.binaryRuleCount = binaryRules.size();
+    header.terminalRuleCount = terminalRules.size();
+    header.dictionaryCount = dictionaryCounts.size();
+    header.stringPoolSize = stringPool.size();
+    ofstream outputFile(binaryFileName, ios::binary);
+    outputFile.write((const char*) &header, sizeof(GrammarFileHeader));
+    writeSection(outputFile, symbolOffsets);
+    writeSection(outputFile, dictionaryOffsets);
+    writeSection(outputFile, dictionaryCounts);
+    writeSection(outputFile, leftHandSides);
+    writeSection(outputFile, types);
+    writeSection(outputFile, rightHandSideOffsets);
+    writeSection(outputFile, rightHandSideIds);
+    writeSection(outputFile, probabilities);
+    writeSection(outputFile, rightSortedOrder);
+    writeSection(outputFile, binaryOrder);
+    writeSection(outputFile, terminalOrder);
+    writeSection(outputFile, terminalOffsets);
+    outputFile.write(stringPool.data(), stringPool.size());
+    outputFile.close();
+    return outputFile.good();
+}
+
+/**
+ * Loads a grammar compiled with saveBinary. The file is mapped into memory and every section is validated before
+ * anything is created: the counts in the header must fit the file, the offsets must stay inside their sections and
+ * the string pool, the symbol ids must be below the symbol count, the rule types must match the right hand side
+ * sizes, the order sections must list the right rules in the order the parsers expect, and the file must be written
+ * by a grammar of the same kind, as isProbabilistic tells. The sections are not used in place; the symbols, rules and
+ * lexicon are created on the heap from the stored ids, and the sorted rule arrays are copied from the stored orders,
+ * so only the hash based lookups are built with updateRuleLookups. Rules are created with createRule, so the method
+ * must be called from the constructor of the most derived grammar. If the file is rejected, the grammar is not
+ * changed.
+ * @param binaryFileName File name of the compiled grammar.
+ * @return True if the grammar is loaded, false if the file can not be read or is not a valid compiled grammar of
+ * this kind.
+ */
+bool ContextFreeGrammar::loadBinary(const string &binaryFileName) {
+    MappedFile file(binaryFileName);
+    const char* data = file.getData();
+    size_t size = file.getSize();
+    if (size < sizeof(GrammarFileHeader)){
+        return false;
+    }
+    GrammarFileHeader header{};
+    memcpy(&header, data, sizeof(GrammarFileHeader));
+    if (!equal(begin(GRAMMAR_FILE_MAGIC), end(GRAMMAR_FILE_MAGIC), header.magic) || header.version != GRAMMAR_FILE_VERSION || header.probabilistic != (isProbabilistic() ? 1 : 0)){
+        return false;
+    }
+    int64_t counts[] = {header.symbolCount, header.nonTerminalCount, header.ruleCount, header.rightHandSideIdCount,
+                        header.binaryRuleCount, header.terminalRuleCount, header.dictionaryCount, header.stringPoolSize};
+    if (ranges::any_of(counts, [](int64_t count){ return count < 0 || count >= numeric_limits<int>::max(); })){
+        return false;
+    }
+    if (header.nonTerminalCount > header.symbolCount || header.startSymbolId < -1 || header.startSymbolId >= header.symbolCount || header.minCount < numeric_limits<int>::min() || header.minCount > numeric_limits<int>::max()){
+        return false;
+    }
+    size_t offset = sizeof(GrammarFileHeader);
+    auto symbolOffsets = readSection<int64_t>(data, size, offset, header.symbolCount + 1);
+    auto dictionaryOffsets = readSection<int64_t>(data, size, offset, header.dictionaryCount + 1);
+    auto dictionaryCounts = readSection<int>(data, size, offset, header.dictionaryCount);
+    auto leftHandSides = readSection<int>(data, size, offset, header.ruleCount);
+    auto types = readSection<int>(data, size, offset, header.ruleCount);
+    auto rightHandSideOffsets = readSection<int>(data, size, offset, header.ruleCount + 1);
+    auto rightHandSideIds = readSection<int>(data, size, offset, header.rightHandSideIdCount);
+    auto probabilities = readSection<double>(data, size, offset, header.ruleCount);
+    auto rightSortedOrder = readSection<int>(data, size, offset, header.ruleCount);
+    auto binaryOrder = readSection<int>(data, size, offset, header.binaryRuleCount);
+    auto terminalOrder = readSection<int>(data, size, offset, header.terminalRuleCount);
+    auto offsets = readSection<int>(data, size, offset, header.symbolCount + 1);
+    if (offset > size || header.stringPoolSize > size - offset){
+        return false;
+    }
+    const char* stringPool = data + offset;
+    if (!validOffsets(symbolOffsets, header.symbolCount, 0, header.stringPoolSize) || !validOffsets(dictionaryOffsets, header.dictionaryCount, 0, header.stringPoolSize)){
+        return false;
+    }
+    if (!validOffsets(rightHandSideOffsets, header.ruleCount, 0, header.rightHandSideIdCount) || rightHandSideOffsets[0] != 0 || rightHandSideOffsets[header.ruleCount] != header.rightHandSideIdCount){
+        return false;
+    }
+    if (!validOffsets(offsets, header.symbolCount, 0, header.terminalRuleCount) || offsets[0] != 0 || offsets[header.symbolCount] != header.terminalRuleCount){
+        return false;
+    }
+    for (int i = 0; i < header.dictionaryCount; i++){
+        if (dictionaryCounts[i] <= 0){
+            return false;
+        }
+    }
+    for (int i = 0; i < header.rightHandSideIdCount; i++){
+        if (rightHandSideIds[i] < 0 || rightHandSideIds[i] >= header.symbolCount){
+            return false;
+        }
+    }
+    int binaryRuleCount = 0, terminalRuleCount = 0;
+    for (int i = 0; i < header.ruleCount; i++){
+        int rightHandSideSize = rightHandSideOffsets[i + 1] - rightHandSideOffsets[i];
+        if (leftHandSides[i] < 0 || leftHandSides[i] >= header.nonTerminalCount || types[i] < (int) RuleType::TERMINAL || types[i] > (int) RuleType::MULTIPLE_NON_TERMINAL){
+            return false;
+        }
+        switch ((RuleType) types[i]){
+            case RuleType::TERMINAL:
+            case RuleType::SINGLE_NON_TERMINAL:
+                if (rightHandSideSize != 1){
+                    return false;
+                }
+                break;
+            case RuleType::TWO_NON_TERMINAL:
+                if (rightHandSideSize != 2){
+                    return false;
+                }
+                break;
+            case RuleType::MULTIPLE_NON_TERMINAL:
+                if (rightHandSideSize <= 2){
+                    return false;
+                }
+                break;
+        }
+        if (isProbabilistic() ? !isfinite(probabilities[i]) || probabilities[i] < 0 : probabilities[i] != 0){
+            return false;
+        }
+        binaryRuleCount += types[i] == (int) RuleType::TWO_NON_TERMINAL;
+        terminalRuleCount += types[i] == (int) RuleType::TERMINAL;
+    }
+    if (binaryRuleCount != header.binaryRuleCount || terminalRuleCount != header.terminalRuleCount){
+        return false;
+    }
+    if (!validOrder(rightSortedOrder, header.ruleCount, types, header.ruleCount, -1) || !validOrder(binaryOrder, header.binaryRuleCount, types, header.ruleCount, (int) RuleType::TWO_NON_TERMINAL) || !validOrder(terminalOrder, header.terminalRuleCount, types, header.ruleCount, (int) RuleType::TERMINAL)){
+        return false;
+    }
+    for (int i = 1; i < header.binaryRuleCount; i++){
+        const int* previous = rightHandSideIds + rightHandSideOffsets[binaryOrder[i - 1]];
+        const int* current = rightHandSideIds + rightHandSideOffsets[binaryOrder[i]];
+        if (make_tuple(previous[0], previous[1], leftHandSides[binaryOrder[i - 1]]) > make_tuple(current[0], current[1], leftHandSides[binaryOrder[i]])){
+            return false;
+        }
+    }
+    for (int i = 0; i < header.symbolCount; i++){
+        for (int j = offsets[i]; j < offsets[i + 1]; j++){
+            if (rightHandSideIds[rightHandSideOffsets[terminalOrder[j]]] != i){
+                return false;
+            }
+        }
+    }
+    vector<Symbol> newSymbols;
+    unordered_map<string, int> newSymbolIds;
+    newSymbols.reserve(header.symbolCount);
+    for (int i = 0; i < header.symbolCount; i++){
+        newSymbols.emplace_back(string(stringPool + symbolOffsets[i], symbolOffsets[i + 1] - symbolOffsets[i]));
+        if (!newSymbolIds.emplace(newSymbols.back().getName(), i).second){
+            return false;
+        }
+    }
+    vector<Rule*> newRules, newRulesRightSorted;
+    newRules.reserve(header.ruleCount);
+    for (int i = 0; i < header.ruleCount; i++){
+        vector<Symbol> rightHandSide;
+        vector<int> ids(rightHandSideIds + rightHandSideOffsets[i], rightHandSideIds + rightHandSideOffsets[i + 1]);
+        for (int id : ids){
+            rightHandSide.emplace_back(newSymbols[id]);
+        }
+        Rule* rule = createRule(newSymbols[leftHandSides[i]], rightHandSide, (RuleType) types[i], probabilities[i]);
+        rule->setSymbolIds(leftHandSides[i], ids);
+        newRules.emplace_back(rule);
+    }
+    for (int i = 0; i < header.ruleCount; i++){
+        newRulesRightSorted.emplace_back(newRules[rightSortedOrder[i]]);
+    }
+    bool sorted = ranges::is_sorted(newRules, [](const Rule* ruleA, const Rule* ruleB){
+        int result = compareRuleLeft3Way(ruleA, ruleB);
+        return result < 0 || (result == 0 && compareRuleRight3Way(ruleA, ruleB) < 0);
+    });
+    if (!sorted || !ranges::is_sorted(newRulesRightSorted, compareRuleRight)){
+        for (Rule* rule : newRules){
+            delete rule;
+        }
+        return false;
+    }
+    minCount = (int) header.minCount;
+    nonTerminalCount = (int) header.nonTerminalCount;
+    startSymbolId = (int) header.startSymbolId;
+    symbols = std::move(newSymbols);
+    symbolIds = std::move(newSymbolIds);
+    dictionary.reserve(header.dictionaryCount);
+    for (int i = 0; i < header.dictionaryCount; i++){
+        dictionary.putNTimes(string(stringPool + dictionaryOffsets[i], dictionaryOffsets[i + 1] - dictionaryOffsets[i]), dictionaryCounts[i]);
+    }
+    rules = std::move(newRules);
+    rulesRightSorted = std::move(newRulesRightSorted);
+    for (int i = 0; i < header.binaryRuleCount; i++){
+        binaryRules.emplace_back(rules[binaryOrder[i]]);
+    }
+    for (int i = 0; i < header.terminalRuleCount; i++){
+        terminalRules.emplace_back(rules[terminalOrder[i]]);
+    }
+    terminalRuleOffsets.assign(offsets, offsets + header.symbolCount + 1);
+    updateRuleLookups();
+    return true;
+}
+
 /**
  * Constructs the lexicon from the given treebank. Reads each tree and for each leaf node in each tree puts the
  * symbol in the dictionary.
@@ -190,6 +921,53 @@ void ContextFreeGrammar::constructDictionary(const TreeBank& treeBank){
     }
 }
 
+/**
+ * Constructs the lexicon from the given treebank with a pool of threads. Every shard of the treebank counts its leaf
+ * symbols in its own counter, and the counters are added to the dictionary in shard order.
+ * @param treeBank Treebank containing the constituency trees.
+ * @param pool Pool of threads counting the shards.
+ */
+void ContextFreeGrammar::constructDictionary(const TreeBank &treeBank, WorkStealingPool &pool) {
+    int shards = shardCount(treeBank, pool);
+    vector<CounterHashMap<string>> shardDictionaries(shards);
+    pool.parallelFor(shards, [&](int shard, int worker){
+        auto [first, last] = shardRange(treeBank, shards, shard);
+        for (int i = first; i < last; i++){
+            NodeCollector nodeCollector = NodeCollector(treeBank.get(i)->getRoot(), new IsLeaf());
+            for (const ParseNode* parseNode : nodeCollector.collect()){
+                shardDictionaries[shard].put(parseNode->getData().getName());
+            }
+        }
+    });
+    for (const CounterHashMap<string>& shardDictionary : shardDictionaries){
+        for (const auto& [word, count] : shardDictionary){
+            dictionary.putNTimes(word, count);
+        }
+    }
+}
+
+/**
+ * Returns the number of shards the treebank is split into in parallel induction. Every thread gets a few shards, so
+ * that the threads stealing shards from each other can balance trees of different sizes.
+ * @param treeBank Treebank to be split.
+ * @param pool Pool of threads processing the shards.
+ * @return Number of shards.
+ */
+int ContextFreeGrammar::shardCount(const TreeBank &treeBank, const WorkStealingPool &pool) {
+    return max(1, min(treeBank.size(), 4 * pool.getThreadCount()));
+}
+
+/**
+ * Returns the range of the trees in the given shard of the treebank.
+ * @param treeBank Treebank to be split.
+ * @param shardCount Number of shards.
+ * @param shard Index of the shard.
+ * @return Index of the first tree of the shard and one past the index of its last tree.
+ */
+pair<int, int> ContextFreeGrammar::shardRange(const TreeBank &treeBank, int shardCount, int shard) {
+    return make_pair((int) ((long long) treeBank.size() * shard / shardCount), (int) ((long long) treeBank.size() * (shard + 1) / shardCount));
+}
+
 /**
  * Updates the exceptional symbols of the leaf nodes in the trees. Constituency trees consists of rare symbols and
  * numbers, which are usually useless in creating constituency grammars. This is due to the fact that, numbers may
@@ -204,16 +982,11 @@ void ContextFreeGrammar::constructDictionary(const TreeBank& treeBank){
 void ContextFreeGrammar::updateTree(const ParseTree* parseTree, int _minCount) const {
     NodeCollector nodeCollector = NodeCollector(parseTree->getRoot(), new IsLeaf());
     vector<ParseNode*> leafList = nodeCollector.collect();
-    regex pattern1 = regex("\\+?\\d+");
-    regex pattern2 = regex(R"(\+?(\d+)?\.\d*)");
     for (ParseNode* parseNode : leafList){
         string data = parseNode->getData().getName();
-        if (regex_match(data, pattern1) || (regex_match(data, pattern2) && data != ".")){
-            parseNode->setData(Symbol("_num_"));
-        } else {
-            if (dictionary.count(data) < _minCount){
-                parseNode->setData(Symbol("_rare_"));
-            }
+        const string& normalized = normalizeWord(data, _minCount);
+        if (&normalized != &data){
+            parseNode->setData(Symbol(normalized));
         }
     }
 }
@@ -229,20 +1002,92 @@ void ContextFreeGrammar::updateTree(const ParseTree* parseTree, int _minCount) c
  * @param sentence Sentence to be updated.
  */
 void ContextFreeGrammar::removeExceptionalWordsFromSentence(const Sentence* sentence) const{
-    regex pattern1 = regex("\\+?\\d+");
-    regex pattern2 = regex(R"(\+?(\d+)?\.\d*)");
     for (int i = 0; i < sentence->wordCount(); i++){
         Word* word = sentence->getWord(i);
-        if (regex_match(word->getName(), pattern1) || (regex_match(word->getName(), pattern2) && word->getName() != ".")){
-            word->setName("_num_");
-        } else {
-            if (dictionary.count(word->getName()) < minCount){
-                word->setName("_rare_");
-            }
+        string name = word->getName();
+        const string& normalized = normalizeWord(name, minCount);
+        if (&normalized != &name){
+            word->setName(normalized);
         }
     }
 }
 
+/**
+ * Batch form of removeExceptionalWordsFromSentence. Updates the exceptional words of all sentences of the corpus in
+ * one pass, converting numbers to _num_ and rare words to _rare_.
+ * @param corpus Corpus whose sentences will be updated.
+ */
+void ContextFreeGrammar::removeExceptionalWordsFromCorpus(const Corpus& corpus) const{
+    for (int i = 0; i < corpus.sentenceCount(); i++){
+        removeExceptionalWordsFromSentence(corpus.getSentence(i));
+    }
+}
+
+/**
+ * Checks if the word is a number, that is, an optional + followed by digits, or an optional + followed by optional
+ * digits, a dot and optional digits, other than a single dot. The word is scanned once, instead of being matched
+ * against regular expressions.
+ * @param word Word to be checked.
+ * @return True if the word is a number, false otherwise.
+ */
+bool ContextFreeGrammar::isNumber(const string& word){
+    int i = 0, length = word.size(), digitCount = 0;
+    if (i < length && word[i] == '+'){
+        i++;
+    }
+    while (i < length && isdigit((unsigned char) word[i])){
+        i++;
+        digitCount++;
+    }
+    if (i == length){
+        return digitCount > 0;
+    }
+    if (word[i] != '.' || word == "."){
+        return false;
+    }
+    i++;
+    while (i < length && isdigit((unsigned char) word[i])){
+        i++;
+    }
+    return i == length;
+}
+
+/**
+ * Returns the terminal symbol the word is converted to in the grammar: _num_ if the word is a number, _rare_ if the
+ * word occurs less than the given number of times in the dictionary, the word itself otherwise. The dictionary is
+ * probed once per word and no string is allocated.
+ * @param word Word to be converted.
+ * @param _minCount Minimum frequency for the words to be considered as rare.
+ * @return _num_, _rare_, or a reference to the word itself.
+ */
+const string& ContextFreeGrammar::normalizeWord(const string& word, int _minCount) const{
+    static const string NUMBER = "_num_";
+    static const string RARE = "_rare_";
+    if (isNumber(word)){
+        return NUMBER;
+    }
+    auto iterator = dictionary.find(word);
+    if ((iterator == dictionary.end() ? 0 : iterator->second) < _minCount){
+        return RARE;
+    }
+    return word;
+}
+
+/**
+ * Converts the words of a sentence to the ids of the terminal symbols used in parsing without changing the words:
+ * numbers are converted to the id of _num_, rare words to the id of _rare_. The ids are written to the given buffer,
+ * so that the surface forms of the words can be used as the leaves of the parse trees.
+ * @param words Words of the sentence.
+ * @param wordSymbolIds Output buffer, the id of the terminal symbol of every word, -1 if the grammar does not
+ *                      contain the symbol.
+ */
+void ContextFreeGrammar::normalizeWords(span<const string> words, vector<int>& wordSymbolIds) const{
+    wordSymbolIds.clear();
+    for (const string& word : words){
+        wordSymbolIds.emplace_back(getSymbolId(normalizeWord(word, minCount)));
+    }
+}
+
 /**
  * After constructing the constituency tree with a parser for a sentence, it contains exceptional words such as
  * rare words and numbers, which are represented as _rare_ and _num_ symbols in the tree. Those words should be
@@ -291,19 +1136,68 @@ Rule* ContextFreeGrammar::toRule(const ParseNode* parseNode, bool trim){
 }
 
 /**
- * Recursive method to generate all rules from a subtree rooted at the given node.
+ * Recursive method to generate all rules from a subtree rooted at the given node. The rules are collected in a hash
+ * set keyed on the whole rule, so that every distinct rule is kept once; the sorted rule lists are built from the set
+ * after all trees are read.
  * @param parseNode Root node of the subtree.
+ * @param inducedRules Distinct rules generated so far.
  */
-void ContextFreeGrammar::addRules(const ParseNode *parseNode) {
+void ContextFreeGrammar::addRules(const ParseNode *parseNode, RuleSet& inducedRules) {
     Rule* newRule;
     newRule = toRule(parseNode, true);
-    addRule(newRule);
+    if (!inducedRules.emplace(newRule).second){
+        delete newRule;
+    }
     for (int i = 0; i < parseNode->numberOfChildren(); i++) {
         ParseNode* childNode = parseNode->getChild(i);
         if (childNode->numberOfChildren() > 0){
-            addRules(childNode);
+            addRules(childNode, inducedRules);
+        }
+    }
+}
+
+/**
+ * Replaces the rules of the grammar with the given rules, and sorts the rules and rulesRightSorted lists once. Rules
+ * are sorted on their left hand sides, and rules with the same left hand side on their right hand sides, so that the
+ * order does not depend on the order of the given rules.
+ * @param newRules New rules of the grammar.
+ */
+void ContextFreeGrammar::setRules(const vector<Rule*>& newRules) {
+    rules = newRules;
+    ranges::sort(rules, [](const Rule* ruleA, const Rule* ruleB){
+        int result = compareRuleLeft3Way(ruleA, ruleB);
+        return result < 0 || (result == 0 && compareRuleRight3Way(ruleA, ruleB) < 0);
+    });
+    rulesRightSorted = rules;
+    ranges::stable_sort(rulesRightSorted, compareRuleRight);
+}
+
+/**
+ * Searches the given rule in the rules list. The list is sorted on the left hand sides only, so the method binary
+ * searches the left hand side of the rule, and then compares the whole rule with the rules having the same left hand
+ * side.
+ * @param rule Rule to be searched.
+ * @return Position of the rule, if the rule exists in the rules list. If the rule does not exist, it returns
+ * -(position + 1), where position is the position at which the rule can be inserted.
+ */
+int ContextFreeGrammar::searchRuleIndex(const Rule* rule) const {
+    int pos = binarySearch(rules, rule, compareRuleLeft3Way);
+    if (pos < 0){
+        return pos;
+    }
+    int first = pos, last = pos;
+    while (first > 0 && compareRuleLeft3Way(rules[first - 1], rule) == 0){
+        first--;
+    }
+    while (last + 1 < rules.size() && compareRuleLeft3Way(rules[last + 1], rule) == 0){
+        last++;
+    }
+    for (int i = first; i <= last; i++){
+        if (*rules[i] == *rule){
+            return i;
         }
     }
+    return -(last + 2);
 }
 
 /**
@@ -332,12 +1226,13 @@ int ContextFreeGrammar::binarySearch(const vector<Rule*> &ruleList, const Rule*
 }
 
 /**
- * Inserts a new rule into the correct position in the sorted rules and rulesRightSorted array lists.
+ * Inserts a new rule into the correct position in the sorted rules and rulesRightSorted array lists, if the grammar
+ * does not already contain an equal rule.
  * @param newRule Rule to be inserted into the sorted array lists.
  */
 void ContextFreeGrammar::addRule(Rule* newRule){
     int pos;
-    pos = binarySearch(rules, newRule, compareRuleLeft3Way);
+    pos = searchRuleIndex(newRule);
     if (pos < 0){
         rules.insert(rules.begin() - pos - 1, newRule);
         pos = binarySearch(rulesRightSorted, newRule, compareRuleRight3Way);
@@ -355,25 +1250,32 @@ void ContextFreeGrammar::addRule(Rule* newRule){
  */
 void ContextFreeGrammar::removeRule(Rule* rule){
     int pos, posUp, posDown;
-    pos = binarySearch(rules, rule, compareRuleLeft3Way);
+    pos = searchRuleIndex(rule);
     if (pos >= 0){
+        Rule* removed = rules[pos];
         rules.erase(rules.begin() + pos);
-        pos = binarySearch(rulesRightSorted, rule, compareRuleRight3Way);
-        posUp = pos;
-        while (posUp >= 0 && compareRuleLeft3Way(rulesRightSorted[posUp], rule) == 0){
-            if (rule == rulesRightSorted[posUp]){
-                rulesRightSorted.erase(rulesRightSorted.begin() + posUp);
-                return;
+        pos = binarySearch(rulesRightSorted, removed, compareRuleRight3Way);
+        if (pos >= 0){
+            posUp = pos;
+            while (posUp >= 0 && compareRuleRight3Way(rulesRightSorted[posUp], removed) == 0){
+                if (removed == rulesRightSorted[posUp]){
+                    rulesRightSorted.erase(rulesRightSorted.begin() + posUp);
+                    return;
+                }
+                posUp--;
             }
-            posUp--;
-        }
-        posDown = pos + 1;
-        while (posDown < rulesRightSorted.size() && compareRuleRight3Way(rulesRightSorted[posDown], rule) == 0){
-            if (rule == rulesRightSorted[posDown]){
-                rulesRightSorted.erase(rulesRightSorted.begin() + posDown);
-                return;
+            posDown = pos + 1;
+            while (posDown < rulesRightSorted.size() && compareRuleRight3Way(rulesRightSorted[posDown], removed) == 0){
+                if (removed == rulesRightSorted[posDown]){
+                    rulesRightSorted.erase(rulesRightSorted.begin() + posDown);
+                    return;
+                }
+                posDown++;
             }
-            posDown++;
+        }
+        auto position = ranges::find(rulesRightSorted, removed);
+        if (position != rulesRightSorted.end()){
+            rulesRightSorted.erase(position);
         }
     }
 }
@@ -388,8 +1290,8 @@ void ContextFreeGrammar::removeRule(Rule* rule){
 vector<Rule*> ContextFreeGrammar::getRulesWithLeftSideX(const Symbol& X){
     int middle, middleUp, middleDown;
     vector<Rule*> result;
-    Rule* dummyRule = new Rule(X, X);
-    middle = binarySearch(rules, dummyRule, compareRuleLeft3Way);
+    Rule dummyRule = Rule(X, X);
+    middle = binarySearch(rules, &dummyRule, compareRuleLeft3Way);
     if (middle >= 0){
         middleUp = middle;
         while (middleUp >= 0 && rules[middleUp]->getLeftHandSide() == X){
@@ -442,8 +1344,8 @@ vector<Symbol> ContextFreeGrammar::getLeftSide() const{
 vector<Rule*> ContextFreeGrammar::getTerminalRulesWithRightSideX(const Symbol& s) const{
     int middle, middleUp, middleDown;
     vector<Rule*> result;
-    Rule* dummyRule = new Rule(s, s);
-    middle = binarySearch(rulesRightSorted, dummyRule, compareRuleRight3Way);
+    Rule dummyRule = Rule(s, s);
+    middle = binarySearch(rulesRightSorted, &dummyRule, compareRuleRight3Way);
     if (middle >= 0){
         middleUp = middle;
         while (middleUp >= 0 && rulesRightSorted[middleUp]->getRightHandSideAt(0) == s){
@@ -463,6 +1365,47 @@ vector<Rule*> ContextFreeGrammar::getTerminalRulesWithRightSideX(const Symbol& s
     return result;
 }
 
+/**
+ * Returns all terminal rules such as X -> s for the terminal symbol with the given id. The rules are read from the
+ * precomputed terminal rule index, therefore the method does not allocate.
+ * @param symbolId Id of the terminal symbol on the right hand side.
+ * @return View of all rules with the given terminal symbol on the right hand side, empty if there is no such rule.
+ */
+span<Rule* const> ContextFreeGrammar::getTerminalRulesWithRightSideX(int symbolId) const{
+    pair<int, int> range = getTerminalRuleRange(symbolId);
+    return span<Rule* const>(terminalRules.data() + range.first, range.second - range.first);
+}
+
+/**
+ * Returns the range of the terminal rules such as X -> s for the terminal symbol with the given id. The positions
+ * in the range can be passed to getTerminalRule and serve as compact ids of the rules.
+ * @param symbolId Id of the terminal symbol on the right hand side.
+ * @return Start (inclusive) and end (exclusive) positions of the rules, an empty range if there is no such rule.
+ */
+pair<int, int> ContextFreeGrammar::getTerminalRuleRange(int symbolId) const{
+    if (symbolId < 0 || symbolId + 1 >= terminalRuleOffsets.size()){
+        return make_pair(0, 0);
+    }
+    return make_pair(terminalRuleOffsets[symbolId], terminalRuleOffsets[symbolId + 1]);
+}
+
+/**
+ * Returns the terminal rule at the given position of the terminal rule index.
+ * @param index Position of the rule, obtained from getTerminalRuleRange.
+ * @return Terminal rule at the given position.
+ */
+Rule* ContextFreeGrammar::getTerminalRule(int index) const{
+    return terminalRules[index];
+}
+
+/**
+ * Returns the number of rules in the terminal rule index.
+ * @return Number of rules such as X -> a.
+ */
+int ContextFreeGrammar::getTerminalRuleCount() const{
+    return terminalRules.size();
+}
+
 /**
  * Returns all rules with the given non-terminal symbol on the right hand side, that is it returns all non-terminal
  * rules such as X -> S
@@ -472,8 +1415,8 @@ vector<Rule*> ContextFreeGrammar::getTerminalRulesWithRightSideX(const Symbol& s
 vector<Rule*> ContextFreeGrammar::getRulesWithRightSideX(const Symbol& S) const{
     int pos, posUp, posDown;
     vector<Rule*> result;
-    Rule* dummyRule = new Rule(S, S);
-    pos = binarySearch(rulesRightSorted, dummyRule, compareRuleRight3Way);
+    Rule dummyRule = Rule(S, S);
+    pos = binarySearch(rulesRightSorted, &dummyRule, compareRuleRight3Way);
     if (pos >= 0){
         posUp = pos;
         while (posUp >= 0 && rulesRightSorted[posUp]->getRightHandSideAt(0) == S && rulesRightSorted[posUp]->getRightHandSideSize() == 1){
@@ -499,8 +1442,8 @@ vector<Rule*> ContextFreeGrammar::getRulesWithRightSideX(const Symbol& S) const{
 vector<Rule*> ContextFreeGrammar::getRulesWithTwoNonTerminalsOnRightSide(const Symbol& A, const Symbol& B) const{
     int pos, posUp, posDown;
     vector<Rule*> result;
-    Rule* dummyRule = new Rule(A, A, B);
-    pos = binarySearch(rulesRightSorted, dummyRule, compareRuleRight3Way);
+    Rule dummyRule = Rule(A, A, B);
+    pos = binarySearch(rulesRightSorted, &dummyRule, compareRuleRight3Way);
     if (pos >= 0){
         posUp = pos;
         while (posUp >= 0 && rulesRightSorted[posUp]->getRightHandSideSize() == 2 && rulesRightSorted[posUp]->getRightHandSideAt(0) == A && rulesRightSorted[posUp]->getRightHandSideAt(1) == B){
@@ -518,100 +1461,350 @@ vector<Rule*> ContextFreeGrammar::getRulesWithTwoNonTerminalsOnRightSide(const S
 }
 
 /**
- * Returns the symbol on the right side of the first rule with one non-terminal symbol on the right hand side, that
- * is it returns S of the first rule such as X -> S. S should also not be in the given removed list.
- * @param removedList Discarded list for symbol S.
- * @return The symbol on the right side of the first rule with one non-terminal symbol on the right hand side. The
- * symbol to be returned should also not be in the given discarded list.
+ * Returns all rules with the given two non-terminal symbols on the right hand side, that is it returns all
+ * non-terminal rules such as X -> AB. The rules are read from the precomputed binary rule index, therefore the method
+ * does not allocate.
+ * @param A Id of the first non-terminal symbol on the right hand side.
+ * @param B Id of the second non-terminal symbol on the right hand side.
+ * @return View of all rules with the given two non-terminal symbols on the right hand side, empty if there is no
+ * such rule.
+ */
+span<Rule* const> ContextFreeGrammar::getRulesWithTwoNonTerminalsOnRightSide(int A, int B) const{
+    pair<int, int> range = getBinaryRuleRange(A, B);
+    return span<Rule* const>(binaryRules.data() + range.first, range.second - range.first);
+}
+
+/**
+ * Returns the range of the rules such as X -> AB in the binary rule index. The positions in the range can be passed
+ * to getBinaryRule and serve as compact ids of the rules.
+ * @param A Id of the first non-terminal symbol on the right hand side.
+ * @param B Id of the second non-terminal symbol on the right hand side.
+ * @return Start (inclusive) and end (exclusive) positions of the rules, an empty range if there is no such rule.
+ */
+pair<int, int> ContextFreeGrammar::getBinaryRuleRange(int A, int B) const{
+    auto iterator = binaryRuleIndex.find(binaryRuleKey(A, B));
+    if (iterator == binaryRuleIndex.end()){
+        return make_pair(0, 0);
+    }
+    return iterator->second;
+}
+
+/**
+ * Returns the binary rule at the given position of the binary rule index.
+ * @param index Position of the rule, obtained from getBinaryRuleRange.
+ * @return Binary rule at the given position.
  */
-Symbol ContextFreeGrammar::getSingleNonTerminalCandidateToRemove(vector<Symbol> removedList) const{
-    Symbol removeCandidate = Symbol("");
-    for (Rule* rule:rules) {
-        if (rule->getRuleType() == RuleType::SINGLE_NON_TERMINAL && !rule->leftRecursive() && ranges::find(removedList, rule->getRightHandSideAt(0)) == removedList.end()) {
-            removeCandidate = rule->getRightHandSideAt(0);
-            break;
+Rule* ContextFreeGrammar::getBinaryRule(int index) const{
+    return binaryRules[index];
+}
+
+/**
+ * Returns the number of rules in the binary rule index.
+ * @return Number of rules such as X -> BC.
+ */
+int ContextFreeGrammar::getBinaryRuleCount() const{
+    return binaryRules.size();
+}
+
+/**
+ * Rules sorted on a key, stored as runs of rules with the same key in the order of the keys. A Fenwick tree over the
+ * sizes of the runs gives the position of every run in the whole sorted list, so that the position binarySearch
+ * would land on in the whole list can be found while rules are added and removed, without moving the other rules.
+ */
+class RuleRuns {
+private:
+    vector<vector<Rule*>> runs;
+    vector<int> sizes;
+    int total = 0;
+    void resize(int run, int delta);
+    [[nodiscard]] int offset(int run) const;
+    [[nodiscard]] int searchRun(int run) const;
+public:
+    explicit RuleRuns(int runCount);
+    [[nodiscard]] const vector<Rule*>& getRun(int run) const;
+    [[nodiscard]] vector<Rule*> searchOrder(int run) const;
+    void append(int run, Rule* rule);
+    void insert(int run, Rule* rule);
+    void erase(int run, const Rule* rule);
+};
+
+/**
+ * Constructor for the RuleRuns class.
+ * @param runCount Number of distinct keys.
+ */
+RuleRuns::RuleRuns(int runCount) : runs(runCount), sizes(runCount + 1, 0){
+}
+
+/**
+ * Updates the size of a run in the Fenwick tree.
+ * @param run Index of the run.
+ * @param delta Change in the size of the run.
+ */
+void RuleRuns::resize(int run, int delta){
+    for (int i = run + 1; i < sizes.size(); i += i & -i){
+        sizes[i] += delta;
+    }
+    total += delta;
+}
+
+/**
+ * Returns the position of the first rule of a run in the whole sorted list.
+ * @param run Index of the run.
+ * @return Number of rules in the runs before the given run.
+ */
+int RuleRuns::offset(int run) const{
+    int result = 0;
+    for (int i = run; i > 0; i -= i & -i){
+        result += sizes[i];
+    }
+    return result;
+}
+
+/**
+ * Repeats binarySearch on the whole sorted list for the key of a run.
+ * @param run Index of the run.
+ * @return Position in the run the search lands on, -1 if the run is empty.
+ */
+int RuleRuns::searchRun(int run) const{
+    int first = offset(run), last = first + (int) runs[run].size();
+    int lo = 0, hi = total - 1;
+    while (lo <= hi){
+        int mid = (lo + hi) / 2;
+        if (mid < first){
+            lo = mid + 1;
+        } else {
+            if (mid >= last){
+                hi = mid - 1;
+            } else {
+                return mid - first;
+            }
         }
     }
-    return removeCandidate;
+    return -1;
+}
+
+/**
+ * Accessor for a run.
+ * @param run Index of the run.
+ * @return Rules with the key of the run, in the order of the sorted list.
+ */
+const vector<Rule*>& RuleRuns::getRun(int run) const{
+    return runs[run];
 }
 
 /**
- * Returns all rules with more than two non-terminal symbols on the right hand side, that is it returns all
- * non-terminal rules such as X -> ABC...
- * @return All rules with more than two non-terminal symbols on the right hand side.
+ * Returns the rules of a run in the order getRulesWithLeftSideX and getRulesWithRightSideX visit them, that is going
+ * up from the position binarySearch lands on, then going down from the next position.
+ * @param run Index of the run.
+ * @return Rules of the run in visiting order.
  */
-Rule* ContextFreeGrammar::getMultipleNonTerminalCandidateToUpdate() const{
-    Rule* removeCandidate = nullptr;
-    for (Rule* rule:rules) {
-        if (rule->getRuleType() == RuleType::MULTIPLE_NON_TERMINAL) {
-            removeCandidate = rule;
-            break;
+vector<Rule*> RuleRuns::searchOrder(int run) const{
+    vector<Rule*> result;
+    int middle = searchRun(run);
+    if (middle >= 0){
+        for (int i = middle; i >= 0; i--){
+            result.emplace_back(runs[run][i]);
+        }
+        for (int i = middle + 1; i < runs[run].size(); i++){
+            result.emplace_back(runs[run][i]);
         }
     }
-    return removeCandidate;
+    return result;
+}
+
+/**
+ * Adds a rule to the end of its run, as addRule does in the rules list.
+ * @param run Index of the run of the rule.
+ * @param rule Rule to be added.
+ */
+void RuleRuns::append(int run, Rule* rule){
+    runs[run].emplace_back(rule);
+    resize(run, 1);
+}
+
+/**
+ * Adds a rule at the position binarySearch lands on in its run, as addRule does in the rulesRightSorted list.
+ * @param run Index of the run of the rule.
+ * @param rule Rule to be added.
+ */
+void RuleRuns::insert(int run, Rule* rule){
+    int position = max(searchRun(run), 0);
+    runs[run].insert(runs[run].begin() + position, rule);
+    resize(run, 1);
+}
+
+/**
+ * Removes a rule from its run.
+ * @param run Index of the run of the rule.
+ * @param rule Rule to be removed.
+ */
+void RuleRuns::erase(int run, const Rule* rule){
+    auto position = ranges::find(runs[run], rule);
+    if (position != runs[run].end()){
+        runs[run].erase(position);
+        resize(run, -1);
+    }
+}
+
+/**
+ * Checks if the given rule is a candidate for removal in conversion to Chomsky Normal Form, that is, if it is a rule
+ * such as X -> Y with a non-terminal Y other than X.
+ * @param rule Rule to be checked.
+ * @return True if the rule is a candidate for removal, false otherwise.
+ */
+static bool isSingleNonTerminalCandidate(const Rule* rule){
+    return rule->getRuleType() == RuleType::SINGLE_NON_TERMINAL && !rule->leftRecursive();
+}
+
+/**
+ * Returns the key of the right hand side of a rule.
+ * @param rule Rule.
+ * @return Names of the symbols on the right hand side separated by spaces.
+ */
+static string rightHandSideKey(const Rule* rule){
+    string result;
+    for (const Symbol& symbol : rule->getRightHandSide()){
+        result += symbol.getName() + " ";
+    }
+    return result;
 }
 
 /**
  * In conversion to Chomsky Normal Form, rules like X -> Y are removed and new rules for every rule as Y -> beta are
- * replaced with X -> beta. The method first identifies all X -> Y rules. For every such rule, all rules Y -> beta
- * are identified. For every such rule, the method adds a new rule X -> beta. Every Y -> beta rule is then deleted.
+ * replaced with X -> beta. The method repeatedly takes the symbol Y of the first rule such as X -> Y in the rules
+ * list. For every rule X -> Y, it adds a new rule X -> beta for every rule Y -> beta, unless the grammar already
+ * contains it, and then removes X -> Y. The rules and rulesRightSorted lists are kept as runs of rules with the same
+ * left hand side and right hand side, so that every step only visits the rules of Y and the rules are visited in the
+ * same order as getRulesWithLeftSideX and getRulesWithRightSideX visit them. createRule creates the new rules with
+ * the product of the probabilities of the two rules.
  */
 void ContextFreeGrammar::removeSingleNonTerminalFromRightHandSide(){
-    vector<Symbol> nonTerminalList;
-    Symbol removeCandidate;
-    vector<Rule*> ruleList;
-    vector<Rule*> candidateList;
-    removeCandidate = getSingleNonTerminalCandidateToRemove(nonTerminalList);
-    while (!removeCandidate.getName().empty()){
-        ruleList = getRulesWithRightSideX(removeCandidate);
-        for (Rule* rule: ruleList){
-            candidateList = getRulesWithLeftSideX(removeCandidate);
-            for (Rule* candidate: candidateList){
-                vector<Symbol> clone;
-                for (const Symbol& symbol: candidate->getRightHandSide()){
-                    clone.emplace_back(symbol.getName());
+    map<string, int> leftRunIndex;
+    unordered_map<string, int> rightRunIndex;
+    for (const Rule* rule : rules){
+        leftRunIndex.emplace(rule->getLeftHandSide().getName(), 0);
+    }
+    int runCount = 0;
+    for (auto& [left, index] : leftRunIndex){
+        index = runCount++;
+    }
+    runCount = 0;
+    for (int i = 0; i < rulesRightSorted.size(); i++){
+        if (i == 0 || compareRuleRight3Way(rulesRightSorted[i - 1], rulesRightSorted[i]) != 0){
+            rightRunIndex.emplace(rightHandSideKey(rulesRightSorted[i]), runCount++);
+        }
+    }
+    RuleRuns leftRuns(leftRunIndex.size()), rightRuns(runCount);
+    vector<int> candidateCounts(leftRunIndex.size(), 0);
+    set<int> candidateLeftRuns;
+    RuleSet ruleSet;
+    for (Rule* rule : rules){
+        int leftRun = leftRunIndex[rule->getLeftHandSide().getName()];
+        leftRuns.append(leftRun, rule);
+        ruleSet.emplace(rule);
+        if (isSingleNonTerminalCandidate(rule) && candidateCounts[leftRun]++ == 0){
+            candidateLeftRuns.emplace(leftRun);
+        }
+    }
+    for (Rule* rule : rulesRightSorted){
+        rightRuns.append(rightRunIndex[rightHandSideKey(rule)], rule);
+    }
+    while (!candidateLeftRuns.empty()){
+        Symbol removeCandidate;
+        for (const Rule* rule : leftRuns.getRun(*candidateLeftRuns.begin())){
+            if (isSingleNonTerminalCandidate(rule)){
+                removeCandidate = rule->getRightHandSideAt(0);
+                break;
+            }
+        }
+        int candidateRun = leftRunIndex[removeCandidate.getName()];
+        vector<Rule*> ruleList = rightRuns.searchOrder(rightRunIndex[removeCandidate.getName() + " "]);
+        for (Rule* rule : ruleList){
+            vector<Rule*> candidateList = leftRuns.searchOrder(candidateRun);
+            for (const Rule* candidate : candidateList){
+                Rule* newRule = createRule(rule->getLeftHandSide(), candidate->getRightHandSide(), candidate->getRuleType(), ruleProbability(rule) * ruleProbability(candidate));
+                if (ruleSet.emplace(newRule).second){
+                    int leftRun = leftRunIndex[newRule->getLeftHandSide().getName()];
+                    leftRuns.append(leftRun, newRule);
+                    rightRuns.insert(rightRunIndex[rightHandSideKey(newRule)], newRule);
+                    if (isSingleNonTerminalCandidate(newRule) && candidateCounts[leftRun]++ == 0){
+                        candidateLeftRuns.emplace(leftRun);
+                    }
+                } else {
+                    delete newRule;
                 }
-                addRule(new Rule(rule->getLeftHandSide(), clone, candidate->getRuleType()));
             }
-            removeRule(rule);
+            int leftRun = leftRunIndex[rule->getLeftHandSide().getName()];
+            ruleSet.erase(rule);
+            leftRuns.erase(leftRun, rule);
+            rightRuns.erase(rightRunIndex[rightHandSideKey(rule)], rule);
+            if (isSingleNonTerminalCandidate(rule) && --candidateCounts[leftRun] == 0){
+                candidateLeftRuns.erase(leftRun);
+            }
+            delete rule;
         }
-        nonTerminalList.emplace_back(removeCandidate);
-        removeCandidate = getSingleNonTerminalCandidateToRemove(nonTerminalList);
     }
+    rules.clear();
+    for (int i = 0; i < leftRunIndex.size(); i++){
+        rules.insert(rules.end(), leftRuns.getRun(i).begin(), leftRuns.getRun(i).end());
+    }
+    rulesRightSorted = rules;
 }
 
 /**
- * In conversion to Chomsky Normal Form, rules like A -> BC... are replaced with A -> X1... and X1 -> BC. This
- * method replaces B and C non-terminals on the right hand side with X1 for all rules in the grammar.
- * @param first Non-terminal symbol B.
- * @param second Non-terminal symbol C.
- * @param with Non-terminal symbol X1.
+ * In conversion to Chomsky Normal Form, rules like A -> BC... are replaced with A -> X1... and X1 -> BC. The method
+ * takes the rules with more than two symbols on the right hand side in the order of the rules list. While such a rule
+ * A -> BC... has more than two symbols, it creates a new symbol X1 and the rule X1 -> BC, and replaces the first
+ * occurrence of BC with X1 in every rule containing it. The rules are indexed by their adjacent symbol pairs, so a
+ * replacement only visits the rules containing the pair; the pairs formed by a replacement are added to the index.
+ * createRule creates the new rules with probability 1.
  */
-void ContextFreeGrammar::updateAllMultipleNonTerminalWithNewRule(const Symbol& first, const Symbol& second, const Symbol& with) const {
-    for (Rule* rule : rules) {
+void ContextFreeGrammar::updateMultipleNonTerminalFromRightHandSide(){
+    vector<Rule*> candidates;
+    unordered_map<string, int> pairSymbolIds;
+    unordered_map<long long, vector<Rule*>> rulesWithPair;
+    auto pairKey = [&pairSymbolIds](const Symbol& first, const Symbol& second){
+        int firstId = pairSymbolIds.emplace(first.getName(), pairSymbolIds.size()).first->second;
+        int secondId = pairSymbolIds.emplace(second.getName(), pairSymbolIds.size()).first->second;
+        return ((long long) firstId << 32) | (unsigned int) secondId;
+    };
+    for (Rule* rule : rules){
         if (rule->getRuleType() == RuleType::MULTIPLE_NON_TERMINAL){
-            rule->updateMultipleNonTerminal(first, second, with);
+            candidates.emplace_back(rule);
+            for (int i = 0; i + 1 < rule->getRightHandSideSize(); i++){
+                rulesWithPair[pairKey(rule->getRightHandSideAt(i), rule->getRightHandSideAt(i + 1))].emplace_back(rule);
+            }
         }
     }
-}
-
-/**
- * In conversion to Chomsky Normal Form, rules like A -> BC... are replaced with A -> X1... and X1 -> BC. This
- * method determines such rules and for every such rule, it adds new rule X1->BC and updates rule A->BC to A->X1.
- */
-void ContextFreeGrammar::updateMultipleNonTerminalFromRightHandSide(){
-    Rule* updateCandidate;
     int newVariableCount = 0;
-    updateCandidate = getMultipleNonTerminalCandidateToUpdate();
-    while (updateCandidate != nullptr){
-        vector<Symbol> newRightHandSide;
-        Symbol newSymbol = Symbol("X" + to_string(newVariableCount));
-        newRightHandSide.emplace_back(updateCandidate->getRightHandSide()[0]);
-        newRightHandSide.emplace_back(updateCandidate->getRightHandSide()[1]);
-        updateAllMultipleNonTerminalWithNewRule(updateCandidate->getRightHandSide()[0], updateCandidate->getRightHandSide()[1], newSymbol);
-        addRule(new Rule(newSymbol, newRightHandSide, RuleType::TWO_NON_TERMINAL));
-        updateCandidate = getMultipleNonTerminalCandidateToUpdate();
-        newVariableCount++;
+    for (Rule* updateCandidate : candidates){
+        while (updateCandidate->getRuleType() == RuleType::MULTIPLE_NON_TERMINAL){
+            Symbol first = updateCandidate->getRightHandSideAt(0);
+            Symbol second = updateCandidate->getRightHandSideAt(1);
+            Symbol newSymbol = Symbol("X" + to_string(newVariableCount));
+            vector<Rule*>& pairRules = rulesWithPair[pairKey(first, second)];
+            unordered_set<Rule*> updated;
+            for (int i = 0; i < pairRules.size(); i++){
+                Rule* rule = pairRules[i];
+                if (rule->getRuleType() != RuleType::MULTIPLE_NON_TERMINAL || !updated.emplace(rule).second || !rule->updateMultipleNonTerminal(first, second, newSymbol)){
+                    continue;
+                }
+                if (rule->getRuleType() == RuleType::MULTIPLE_NON_TERMINAL){
+                    const vector<Symbol>& rightHandSide = rule->getRightHandSide();
+                    int position = ranges::find(rightHandSide, newSymbol) - rightHandSide.begin();
+                    if (position > 0){
+                        rulesWithPair[pairKey(rightHandSide[position - 1], newSymbol)].emplace_back(rule);
+                    }
+                    if (position + 1 < rightHandSide.size()){
+                        rulesWithPair[pairKey(newSymbol, rightHandSide[position + 1])].emplace_back(rule);
+                    }
+                }
+            }
+            Rule* newRule = createRule(newSymbol, {first, second}, RuleType::TWO_NON_TERMINAL, 1.0);
+            rules.emplace_back(newRule);
+            rulesRightSorted.emplace_back(newRule);
+            newVariableCount++;
+        }
     }
 }
 
@@ -621,10 +1814,24 @@ void ContextFreeGrammar::updateMultipleNonTerminalFromRightHandSide(){
  * and X1 -> BC.
  */
 void ContextFreeGrammar::convertToChomskyNormalForm(){
-    removeSingleNonTerminalFromRightHandSide();
+    convertToChomskyNormalForm(true);
+}
+
+/**
+ * The method converts the grammar into Chomsky normal form, optionally keeping the unary rules. Removing rules like
+ * X -> Y copies every rule Y -> beta to X, which multiplies the size of the grammar; if they are kept, the grammar is
+ * only binarized, the parsers apply the unary closure of the grammar to every cell of the chart instead, and the
+ * unary rules appear in the parse trees.
+ * @param removeUnaryRules If true, rules like X -> Y are removed; otherwise only rules like A -> BC... are replaced.
+ */
+void ContextFreeGrammar::convertToChomskyNormalForm(bool removeUnaryRules){
+    if (removeUnaryRules){
+        removeSingleNonTerminalFromRightHandSide();
+    }
     updateMultipleNonTerminalFromRightHandSide();
-    ranges::sort(rules, compareRuleLeft);
-    ranges::sort(rulesRightSorted, compareRuleRight);
+    setRules(rules);
+    updateSymbolIds();
+    updateRuleIndex();
 }
 
 /**
@@ -634,7 +1841,7 @@ void ContextFreeGrammar::convertToChomskyNormalForm(){
  */
 Rule* ContextFreeGrammar::searchRule(const Rule* rule) const{
     int pos;
-    pos = binarySearch(rules, rule, compareRuleLeft3Way);
+    pos = searchRuleIndex(rule);
     if (pos >= 0){
         return rules[pos];
     } else {
@@ -648,4 +1855,50 @@ Rule* ContextFreeGrammar::searchRule(const Rule* rule) const{
  */
 int ContextFreeGrammar::size() const{
     return rules.size();
-}
\ No newline at end of file
+}
+
+/**
+ * Returns the integer id of the symbol with the given name.
+ * @param name Name of the symbol.
+ * @return Id of the symbol, -1 if the symbol does not occur in the grammar.
+ */
+int ContextFreeGrammar::getSymbolId(const string& name) const{
+    auto iterator = symbolIds.find(name);
+    if (iterator != symbolIds.end()){
+        return iterator->second;
+    }
+    return -1;
+}
+
+/**
+ * Returns the symbol with the given integer id.
+ * @param symbolId Id of the symbol.
+ * @return Symbol with the given id.
+ */
+const Symbol& ContextFreeGrammar::getSymbol(int symbolId) const{
+    return symbols[symbolId];
+}
+
+/**
+ * Returns number of distinct symbols (terminals and non-terminals) in the grammar.
+ * @return Number of distinct symbols in the grammar.
+ */
+int ContextFreeGrammar::getSymbolCount() const{
+    return symbols.size();
+}
+
+/**
+ * Returns number of non-terminal symbols in the grammar. Non-terminals have the ids 0, 1, ..., getNonTerminalCount() - 1.
+ * @return Number of non-terminal symbols in the grammar.
+ */
+int ContextFreeGrammar::getNonTerminalCount() const{
+    return nonTerminalCount;
+}
+
+/**
+ * Accessor for the id of the start symbol S.
+ * @return Id of the start symbol, -1 if the grammar does not contain the start symbol.
+ */
+int ContextFreeGrammar::getStartSymbolId() const{
+    return startSymbolId;
+}
@@ -5,34 +5,86 @@
 #ifndef SYNTACTICPARSER_CONTEXTFREEGRAMMAR_H
 #define SYNTACTICPARSER_CONTEXTFREEGRAMMAR_H
 
+#include <span>
 #include <string>
+#include <unordered_map>
 #include "CounterHashMap.h"
+#include "Corpus.h"
 #include "Rule.h"
 #include "TreeBank.h"
 #include "Sentence.h"
 
 using namespace std;
 
+class WorkStealingPool;
+
+/**
+ * Entry of the unary closure of a non-terminal Y: the chain of unary rules X -> Z -> ... -> Y with the best log
+ * probability, the shortest one in a non-probabilistic grammar. The chain is stored from the top: rule is X -> Z, and
+ * below is the index of the entry of Z in the unary closure, -1 if Z is Y itself.
+ */
+struct UnaryClosureEntry {
+    int symbolId;
+    int below;
+    Rule* rule;
+    double logProbability;
+};
+
 class ContextFreeGrammar {
 protected:
     CounterHashMap<string> dictionary;
     vector<Rule*> rules;
     vector<Rule*> rulesRightSorted;
     int minCount = 1;
+    unordered_map<string, int> symbolIds;
+    vector<Symbol> symbols;
+    int nonTerminalCount = 0;
+    int startSymbolId = -1;
+    vector<Rule*> binaryRules;
+    unordered_map<long long, pair<int, int>> binaryRuleIndex;
+    vector<Rule*> terminalRules;
+    vector<int> terminalRuleOffsets;
+    vector<UnaryClosureEntry> unaryClosure;
+    vector<int> unaryClosureOffsets;
+    vector<Rule*> leftCornerRules;
+    vector<int> leftCornerRuleOffsets;
+    vector<int> leftCorners;
+    vector<int> leftCornerOffsets;
+    bool multipleNonTerminalRules = false;
     void readDictionary(const string& dictionaryFileName);
     void updateTypes() const;
+    void updateSymbolIds();
+    void updateRuleIndex();
+    virtual void updateRuleLookups();
+    [[nodiscard]] virtual Rule* createRule(const Symbol& leftHandSide, const vector<Symbol>& rightHandSide, RuleType type, double probability) const;
+    [[nodiscard]] virtual double ruleProbability(const Rule* rule) const;
+    [[nodiscard]] virtual double ruleLogProbability(const Rule* rule) const;
+    [[nodiscard]] virtual bool isProbabilistic() const;
+    void updateUnaryClosure();
+    void updateLeftCornerIndex();
+    bool loadBinary(const string& binaryFileName);
     void constructDictionary(const TreeBank& treeBank);
-    [[nodiscard]] Symbol getSingleNonTerminalCandidateToRemove(vector<Symbol> removedList) const;
-    [[nodiscard]] Rule* getMultipleNonTerminalCandidateToUpdate() const;
-    void updateAllMultipleNonTerminalWithNewRule(const Symbol& first, const Symbol& second, const Symbol& with) const;
+    void constructDictionary(const TreeBank& treeBank, WorkStealingPool& pool);
+    [[nodiscard]] static int shardCount(const TreeBank& treeBank, const WorkStealingPool& pool);
+    [[nodiscard]] static pair<int, int> shardRange(const TreeBank& treeBank, int shardCount, int shard);
+    void setRules(const vector<Rule*>& newRules);
+    [[nodiscard]] int searchRuleIndex(const Rule* rule) const;
 public:
     ContextFreeGrammar() = default;
+    virtual ~ContextFreeGrammar() = default;
     ContextFreeGrammar(const string& ruleFileName,
                        const string& dictionaryFileName,
                        int minCount);
     ContextFreeGrammar(const TreeBank& treeBank, int minCount);
+    ContextFreeGrammar(const TreeBank& treeBank, int minCount, int threadCount);
+    explicit ContextFreeGrammar(const string& binaryFileName);
+    bool saveBinary(const string& binaryFileName) const;
     void updateTree(const ParseTree* parseTree, int _minCount) const;
     void removeExceptionalWordsFromSentence(const Sentence* sentence) const;
+    void removeExceptionalWordsFromCorpus(const Corpus& corpus) const;
+    [[nodiscard]] static bool isNumber(const string& word);
+    [[nodiscard]] const string& normalizeWord(const string& word, int _minCount) const;
+    void normalizeWords(span<const string> words, vector<int>& wordSymbolIds) const;
     void reinsertExceptionalWordsFromSentence(const ParseTree* parseTree, const Sentence* sentence) const;
     static Rule* toRule(const ParseNode* parseNode, bool trim);
     void addRule(Rule* newRule);
@@ -41,17 +93,38 @@ public:
     [[nodiscard]] vector<Symbol> partOfSpeechTags() const;
     [[nodiscard]] vector<Symbol> getLeftSide() const;
     [[nodiscard]] vector<Rule*> getTerminalRulesWithRightSideX(const Symbol& s) const;
+    [[nodiscard]] span<Rule* const> getTerminalRulesWithRightSideX(int symbolId) const;
     [[nodiscard]] vector<Rule*> getRulesWithRightSideX(const Symbol& S) const;
     [[nodiscard]] vector<Rule*> getRulesWithTwoNonTerminalsOnRightSide(const Symbol& A, const Symbol& B) const;
+    [[nodiscard]] span<Rule* const> getRulesWithTwoNonTerminalsOnRightSide(int A, int B) const;
+    [[nodiscard]] pair<int, int> getBinaryRuleRange(int A, int B) const;
+    [[nodiscard]] Rule* getBinaryRule(int index) const;
+    [[nodiscard]] int getBinaryRuleCount() const;
+    [[nodiscard]] pair<int, int> getTerminalRuleRange(int symbolId) const;
+    [[nodiscard]] Rule* getTerminalRule(int index) const;
+    [[nodiscard]] int getTerminalRuleCount() const;
+    [[nodiscard]] bool hasUnaryRules() const;
+    [[nodiscard]] bool hasMultipleNonTerminalRules() const;
+    [[nodiscard]] pair<int, int> getUnaryClosureRange(int symbolId) const;
+    [[nodiscard]] const UnaryClosureEntry& getUnaryClosureEntry(int index) const;
+    [[nodiscard]] pair<int, int> getLeftCornerRuleRange(int symbolId) const;
+    [[nodiscard]] Rule* getLeftCornerRule(int index) const;
+    [[nodiscard]] span<const int> getLeftCornerClosure(int symbolId) const;
     void convertToChomskyNormalForm();
+    void convertToChomskyNormalForm(bool removeUnaryRules);
     Rule* searchRule(const Rule* rule) const;
     [[nodiscard]] int size() const;
+    [[nodiscard]] int getSymbolId(const string& name) const;
+    [[nodiscard]] const Symbol& getSymbol(int symbolId) const;
+    [[nodiscard]] int getSymbolCount() const;
+    [[nodiscard]] int getNonTerminalCount() const;
+    [[nodiscard]] int getStartSymbolId() const;
     static bool compareRuleLeft(const Rule* ruleA, const Rule* ruleB);
     static int compareRuleLeft3Way(const Rule* ruleA, const Rule* ruleB);
     static bool compareRuleRight(const Rule* ruleA, const Rule* ruleB);
     static int compareRuleRight3Way(const Rule* ruleA, const Rule* ruleB);
 private:
-    void addRules(const ParseNode* parseNode);
+    void addRules(const ParseNode* parseNode, RuleSet& inducedRules);
     int binarySearch(const vector<Rule*> &ruleList, const Rule* rule, int compareRule(const Rule* ruleA, const Rule* ruleB)) const;
     void removeSingleNonTerminalFromRightHandSide();
     void updateMultipleNonTerminalFromRightHandSide();
@@ -0,0 +1,73 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include "GrammarFile.h"
+#include <fstream>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SYNTACTICPARSER_MMAP
+#endif
+
+/**
+ * Opens the given file and maps it into memory. If the file can not be opened, the view is empty.
+ * @param fileName Name of the file.
+ */
+MappedFile::MappedFile(const string &fileName) {
+#ifdef SYNTACTICPARSER_MMAP
+    int descriptor = open(fileName.c_str(), O_RDONLY);
+    if (descriptor >= 0){
+        struct stat status{};
+        if (fstat(descriptor, &status) == 0 && status.st_size > 0){
+            void* address = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (address != MAP_FAILED){
+                data = (const char*) address;
+                size = status.st_size;
+                mapped = true;
+            }
+        }
+        close(descriptor);
+        if (mapped){
+            return;
+        }
+    }
+#endif
+    ifstream inputFile(fileName, ios::binary | ios::ate);
+    if (inputFile.good()){
+        buffer.resize(inputFile.tellg());
+        inputFile.seekg(0);
+        inputFile.read(buffer.data(), buffer.size());
+        data = buffer.data();
+        size = inputFile.good() ? buffer.size() : 0;
+    }
+}
+
+/**
+ * Unmaps the file.
+ */
+MappedFile::~MappedFile() {
+#ifdef SYNTACTICPARSER_MMAP
+    if (mapped){
+        munmap((void*) data, size);
+    }
+#endif
+}
+
+/**
+ * Accessor for the contents of the file.
+ * @return Pointer to the first byte of the file.
+ */
+const char *MappedFile::getData() const {
+    return data;
+}
+
+/**
+ * Accessor for the size of the file.
+ * @return Size of the file in bytes, 0 if the file could not be read.
+ */
+size_t MappedFile::getSize() const {
+    return size;
+}
@@ -0,0 +1,67 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#ifndef SYNTACTICPARSER_GRAMMARFILE_H
+#define SYNTACTICPARSER_GRAMMARFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Header of the compiled binary grammar format. The header is followed by the sections below, each padded to a
+ * multiple of 8 bytes, so that the numbers of every section are aligned and can be read directly from the mapped file:
+ * symbol name offsets (int64, symbolCount + 1), dictionary word offsets (int64, dictionaryCount + 1), dictionary
+ * counts (int32), left hand side ids of the rules (int32), rule types (int32), right hand side offsets of the rules
+ * (int32, ruleCount + 1), right hand side ids (int32), rule probabilities (double), the rulesRightSorted order, the
+ * binaryRules order and the terminalRules order as rule indexes (int32), terminal rule offsets (int32,
+ * symbolCount + 1), and the string pool holding the symbol names and the dictionary words. Rules are stored in the
+ * order of the rules array, so no sorting is needed while loading. The sections are validated and copied into the
+ * heap structures of the grammar while loading; none of them is used in place after the file is closed. Numbers are
+ * stored in the byte order of the machine; a file written on a machine with another byte order is rejected by its
+ * version field.
+ */
+struct GrammarFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t probabilistic;
+    int64_t minCount;
+    int64_t symbolCount;
+    int64_t nonTerminalCount;
+    int64_t startSymbolId;
+    int64_t ruleCount;
+    int64_t rightHandSideIdCount;
+    int64_t binaryRuleCount;
+    int64_t terminalRuleCount;
+    int64_t dictionaryCount;
+    int64_t stringPoolSize;
+};
+
+inline constexpr char GRAMMAR_FILE_MAGIC[8] = {'S', 'P', 'G', 'R', 'A', 'M', 'B', '1'};
+inline constexpr uint32_t GRAMMAR_FILE_VERSION = 1;
+
+/**
+ * Read only view of a whole file. On POSIX systems the file is mapped into memory with mmap, so that opening a large
+ * compiled grammar costs no reads until its pages are used; elsewhere the file is read into a buffer.
+ */
+class MappedFile {
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+    vector<char> buffer;
+    bool mapped = false;
+public:
+    explicit MappedFile(const string& fileName);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    [[nodiscard]] const char* getData() const;
+    [[nodiscard]] size_t getSize() const;
+};
+
+
+#endif //SYNTACTICPARSER_GRAMMARFILE_H
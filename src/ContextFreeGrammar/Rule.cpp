@@ -58,8 +58,8 @@ Rule::Rule(const Symbol& leftHandSide, const vector<Symbol> &rightHandSide, Rule
  * @param ruleString String containing the rule. The string is of the form X -> ....
  */
 Rule::Rule(const string &ruleString) {
-    string left = ruleString.substr(0, ruleString.find("->"));
-    string right = ruleString.substr(ruleString.find("->") + 2);
+    string left = StringUtils::trim(ruleString.substr(0, ruleString.find("->")));
+    string right = StringUtils::trim(ruleString.substr(ruleString.find("->") + 2));
     leftHandSide = Symbol(left);
     vector<string> rightSide = StringUtils::split(right, " ");
     for (const string& s : rightSide){
@@ -88,7 +88,7 @@ RuleType Rule::getRuleType() const {
  * Accessor for the left hand side.
  * @return Left hand side.
  */
-Symbol Rule::getLeftHandSide() const {
+const Symbol& Rule::getLeftHandSide() const {
     return leftHandSide;
 }
 
@@ -96,7 +96,7 @@ Symbol Rule::getLeftHandSide() const {
  * Accessor for the right hand side.
  * @return Right hand side.
  */
-vector<Symbol> Rule::getRightHandSide() const{
+const vector<Symbol>& Rule::getRightHandSide() const{
     return rightHandSide;
 }
 
@@ -113,10 +113,45 @@ int Rule::getRightHandSideSize() const{
  * @param index Position of the symbol
  * @return Symbol at position index on the right hand side.
  */
-Symbol Rule::getRightHandSideAt(int index) const{
+const Symbol& Rule::getRightHandSideAt(int index) const{
     return rightHandSide[index];
 }
 
+/**
+ * Accessor for the integer id of the left hand side symbol. The id is assigned by the grammar containing the rule.
+ * @return Id of the left hand side symbol, -1 if the grammar has not assigned ids yet.
+ */
+int Rule::getLeftHandSideId() const{
+    return leftHandSideId;
+}
+
+/**
+ * Returns the integer id of the symbol at position index on the right hand side.
+ * @param index Position of the symbol
+ * @return Id of the symbol at position index on the right hand side.
+ */
+int Rule::getRightHandSideIdAt(int index) const{
+    return rightHandSideIds[index];
+}
+
+/**
+ * Checks if the grammar has assigned integer ids to the symbols of the rule.
+ * @return True, if the symbol ids are valid; false otherwise.
+ */
+bool Rule::hasSymbolIds() const{
+    return leftHandSideId != -1 && rightHandSideIds.size() == rightHandSide.size();
+}
+
+/**
+ * Mutator for the integer ids of the symbols of the rule.
+ * @param leftHandSideId Id of the left hand side symbol.
+ * @param rightHandSideIds Ids of the right hand side symbols.
+ */
+void Rule::setSymbolIds(int leftHandSideId, const vector<int>& rightHandSideIds){
+    this->leftHandSideId = leftHandSideId;
+    this->rightHandSideIds = rightHandSideIds;
+}
+
 /**
  * Converts the rule to the form X -> ...
  * @return String form of the rule in the form of X -> ...
@@ -152,6 +187,7 @@ bool Rule::updateMultipleNonTerminal(const Symbol& first, const Symbol& second,
             rightHandSide.erase(rightHandSide.begin() + i + 1);
             rightHandSide.erase(rightHandSide.begin() + i);
             rightHandSide.insert(rightHandSide.begin() + i, with);
+            rightHandSideIds.clear();
             if (rightHandSide.size() == 2){
                 type = RuleType::TWO_NON_TERMINAL;
             }
@@ -159,4 +195,28 @@ bool Rule::updateMultipleNonTerminal(const Symbol& first, const Symbol& second,
         }
     }
     return false;
-}
\ No newline at end of file
+}
+
+/**
+ * Hashes a rule on its left hand side and all symbols of its right hand side, so that rules equal according to
+ * operator== have the same hash.
+ * @param rule Rule to be hashed.
+ * @return Hash of the rule.
+ */
+size_t RuleHash::operator()(const Rule *rule) const {
+    size_t result = hash<string>()(rule->getLeftHandSide().getName());
+    for (const Symbol& symbol : rule->getRightHandSide()){
+        result = result * 31 + hash<string>()(symbol.getName());
+    }
+    return result;
+}
+
+/**
+ * Compares two rules on their left hand sides and all symbols of their right hand sides.
+ * @param ruleA the first rule to be compared.
+ * @param ruleB the second rule to be compared.
+ * @return True if the rules are equal, false otherwise.
+ */
+bool RuleEqual::operator()(const Rule *ruleA, const Rule *ruleB) const {
+    return *ruleA == *ruleB;
+}
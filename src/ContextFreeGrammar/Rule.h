@@ -6,6 +6,7 @@
 #define SYNTACTICPARSER_RULE_H
 
 #include <Symbol.h>
+#include <unordered_set>
 #include "RuleType.h"
 
 using namespace std;
@@ -15,6 +16,8 @@ protected:
     Symbol leftHandSide;
     vector<Symbol> rightHandSide;
     RuleType type;
+    int leftHandSideId = -1;
+    vector<int> rightHandSideIds;
 public:
     Rule();
     Rule(const Symbol& leftHandSide, const Symbol& rightHandSideSymbol);
@@ -22,12 +25,17 @@ public:
     Rule(const Symbol& leftHandSide, const vector<Symbol>& rightHandSide);
     Rule(const Symbol& leftHandSide, const vector<Symbol>& rightHandSide, RuleType type);
     explicit Rule(const string& ruleString);
+    virtual ~Rule() = default;
     [[nodiscard]] bool leftRecursive() const;
     [[nodiscard]] RuleType getRuleType() const;
-    [[nodiscard]] Symbol getLeftHandSide() const;
-    [[nodiscard]] vector<Symbol> getRightHandSide() const;
+    [[nodiscard]] const Symbol& getLeftHandSide() const;
+    [[nodiscard]] const vector<Symbol>& getRightHandSide() const;
     [[nodiscard]] int getRightHandSideSize() const;
-    [[nodiscard]] Symbol getRightHandSideAt(int index) const;
+    [[nodiscard]] const Symbol& getRightHandSideAt(int index) const;
+    [[nodiscard]] int getLeftHandSideId() const;
+    [[nodiscard]] int getRightHandSideIdAt(int index) const;
+    [[nodiscard]] bool hasSymbolIds() const;
+    void setSymbolIds(int leftHandSideId, const vector<int>& rightHandSideIds);
     [[nodiscard]] string to_string() const;
     void setType(RuleType ruleType);
     bool updateMultipleNonTerminal(const Symbol& first, const Symbol& second, const Symbol& with);
@@ -48,4 +56,15 @@ public:
         return true;
     }
 };
+
+struct RuleHash {
+    size_t operator()(const Rule* rule) const;
+};
+
+struct RuleEqual {
+    bool operator()(const Rule* ruleA, const Rule* ruleB) const;
+};
+
+using RuleSet = unordered_set<Rule*, RuleHash, RuleEqual>;
+
 #endif //SYNTACTICPARSER_RULE_H
@@ -0,0 +1,354 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include "InsideOutsideTrainer.h"
+
+/**
+ * Constructor for the inside-outside trainer. Starts the worker threads computing the expected counts.
+ * @param threadCount Number of worker threads. If it is not positive, the number of hardware threads is used.
+ */
+InsideOutsideTrainer::InsideOutsideTrainer(int threadCount) : pool(threadCount) {
+    charts.resize(pool.getThreadCount());
+}
+
+/**
+ * Adds an unannotated sentence to the training sentences.
+ * @param sentence Sentence to be added. Its words are copied.
+ */
+void InsideOutsideTrainer::addSentence(const Sentence* sentence){
+    addSentence(sentence, {});
+}
+
+/**
+ * Adds a partially bracketed sentence to the training sentences. Only the derivations whose constituents do not cross
+ * any of the brackets are counted for the sentence.
+ * @param sentence Sentence to be added. Its words are copied.
+ * @param sentenceBrackets Start and end positions, both inclusive, of the known constituents of the sentence.
+ */
+void InsideOutsideTrainer::addSentence(const Sentence* sentence, const vector<pair<int, int>>& sentenceBrackets){
+    vector<string> words;
+    for (int i = 0; i < sentence->wordCount(); i++){
+        words.emplace_back(sentence->getWord(i)->getName());
+    }
+    sentences.emplace_back(words);
+    brackets.emplace_back(sentenceBrackets);
+}
+
+/**
+ * Adds all sentences of the given corpus to the training sentences, unannotated.
+ * @param corpus Corpus whose sentences will be added.
+ */
+void InsideOutsideTrainer::addCorpus(const Corpus& corpus){
+    for (int i = 0; i < corpus.sentenceCount(); i++){
+        addSentence(corpus.getSentence(i));
+    }
+}
+
+/**
+ * Mutator for the checkpoint file. If it is set, train writes the grammar to the file in the compiled binary format
+ * after every iteration, so that an interrupted training can be resumed from the grammar loaded from the file.
+ * @param checkpointFileName File name of the compiled grammar written after every iteration.
+ */
+void InsideOutsideTrainer::setCheckpointFileName(const string& checkpointFileName){
+    this->checkpointFileName = checkpointFileName;
+}
+
+/**
+ * Returns the number of training sentences.
+ * @return Number of training sentences.
+ */
+int InsideOutsideTrainer::sentenceCount() const{
+    return sentences.size();
+}
+
+/**
+ * Returns the number of training sentences having a derivation in the last iteration. The other sentences do not
+ * contribute to the expected counts.
+ * @return Number of sentences having a derivation.
+ */
+int InsideOutsideTrainer::getParsedCount() const{
+    return parsedCount;
+}
+
+/**
+ * Returns the position of the span (i, j) in the inside and outside scales of a chart.
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @return Position of the span.
+ */
+int InsideOutsideTrainer::cellIndex(int i, int j){
+    return j * (j + 1) / 2 + i;
+}
+
+/**
+ * Divides the given probabilities by the largest one and adds the logarithm of the largest one to the scale.
+ * @param values Probabilities of the non-terminals over a span.
+ * @param count Number of non-terminals.
+ * @param scale Logarithm of the scale of the probabilities before the division; the scale after the division, minus
+ *              infinity if all probabilities are zero.
+ */
+static void normalizeCell(double* values, int count, double& scale){
+    double maximum = 0.0;
+    for (int i = 0; i < count; i++){
+        maximum = max(maximum, values[i]);
+    }
+    if (maximum == 0.0){
+        scale = -numeric_limits<double>::infinity();
+        return;
+    }
+    for (int i = 0; i < count; i++){
+        values[i] /= maximum;
+    }
+    scale += log(maximum);
+}
+
+/**
+ * Adds the expected counts of the rules in the derivations of one sentence to the given counts. The inside
+ * probabilities are computed bottom up and the outside probabilities top down; every span keeps its probabilities
+ * scaled to at most 1 with a separate log scale, so long sentences do not underflow, and the derivations of a span
+ * over different split points are added after bringing them to a common scale. The expected count of a binary rule
+ * A -> BC over the spans (i, k) and (k + 1, j) is the outside probability of A over (i, j) times the probability of
+ * the rule times the inside probabilities of B and C, divided by the probability of the sentence; it is accumulated
+ * while the outside probability of B is computed. Spans crossing a bracket of the sentence have no derivation.
+ * @param pCfg Grammar in Chomsky normal form without unary rules.
+ * @param sentence Index of the sentence.
+ * @param chart Chart of the worker computing the counts.
+ * @param counts Expected counts of the shard the sentence belongs to.
+ */
+void InsideOutsideTrainer::addExpectedCounts(const ProbabilisticContextFreeGrammar& pCfg, int sentence, InsideOutsideChart& chart, ExpectedCounts& counts) const{
+    int i, j, k, h, r, B, wordCount = sentences[sentence].size(), nonTerminalCount = pCfg.getNonTerminalCount(), startSymbolId = pCfg.getStartSymbolId();
+    double scale, maximum;
+    pair<int, int> range;
+    if (wordCount == 0){
+        return;
+    }
+    int cellCount = wordCount * (wordCount + 1) / 2;
+    pCfg.normalizeWords(sentences[sentence], chart.wordSymbolIds);
+    chart.allowed.assign(cellCount, 1);
+    for (const auto& [start, end] : brackets[sentence]){
+        for (j = 0; j < wordCount; j++){
+            for (i = 0; i <= j; i++){
+                if ((start < i && i <= end && end < j) || (i < start && start <= j && j < end)){
+                    chart.allowed[cellIndex(i, j)] = 0;
+                }
+            }
+        }
+    }
+    chart.inside.assign((size_t) cellCount * nonTerminalCount, 0.0);
+    chart.insideScales.assign(cellCount, 0.0);
+    for (i = 0; i < wordCount; i++){
+        double* cell = chart.inside.data() + (size_t) cellIndex(i, i) * nonTerminalCount;
+        range = pCfg.getTerminalRuleRange(chart.wordSymbolIds[i]);
+        for (r = range.first; r < range.second; r++){
+            Rule* rule = pCfg.getTerminalRule(r);
+            cell[rule->getLeftHandSideId()] += ((ProbabilisticRule*) rule)->getProbability();
+        }
+        normalizeCell(cell, nonTerminalCount, chart.insideScales[cellIndex(i, i)]);
+    }
+    for (int length = 1; length < wordCount; length++){
+        for (i = 0; i + length < wordCount; i++){
+            j = i + length;
+            double& cellScale = chart.insideScales[cellIndex(i, j)];
+            maximum = -numeric_limits<double>::infinity();
+            for (k = i; k < j; k++){
+                maximum = max(maximum, chart.insideScales[cellIndex(i, k)] + chart.insideScales[cellIndex(k + 1, j)]);
+            }
+            if (!chart.allowed[cellIndex(i, j)] || maximum == -numeric_limits<double>::infinity()){
+                cellScale = -numeric_limits<double>::infinity();
+                continue;
+            }
+            double* parent = chart.inside.data() + (size_t) cellIndex(i, j) * nonTerminalCount;
+            for (k = i; k < j; k++){
+                scale = chart.insideScales[cellIndex(i, k)] + chart.insideScales[cellIndex(k + 1, j)];
+                if (scale == -numeric_limits<double>::infinity()){
+                    continue;
+                }
+                double factor = exp(scale - maximum);
+                const double* left = chart.inside.data() + (size_t) cellIndex(i, k) * nonTerminalCount;
+                const double* right = chart.inside.data() + (size_t) cellIndex(k + 1, j) * nonTerminalCount;
+                for (B = 0; B < nonTerminalCount; B++){
+                    if (left[B] == 0.0){
+                        continue;
+                    }
+                    BinaryRuleBlock block = pCfg.getBinaryRulesWithLeftChild(B);
+                    double leftFactor = left[B] * factor;
+                    for (r = 0; r < block.size; r++){
+                        parent[block.parents[r]] += binaryProbabilities[block.ruleIndexes[r]] * leftFactor * right[block.rightChildren[r]];
+                    }
+                }
+            }
+            cellScale = maximum;
+            normalizeCell(parent, nonTerminalCount, cellScale);
+        }
+    }
+    int root = cellIndex(0, wordCount - 1);
+    if (startSymbolId == -1 || startSymbolId >= nonTerminalCount || chart.inside[(size_t) root * nonTerminalCount + startSymbolId] == 0.0){
+        return;
+    }
+    double logSentence = log(chart.inside[(size_t) root * nonTerminalCount + startSymbolId]) + chart.insideScales[root];
+    chart.outside.assign((size_t) cellCount * nonTerminalCount, 0.0);
+    chart.outsideScales.assign(cellCount, -numeric_limits<double>::infinity());
+    chart.outside[(size_t) root * nonTerminalCount + startSymbolId] = 1.0;
+    chart.outsideScales[root] = 0.0;
+    for (int length = wordCount - 2; length >= 0; length--){
+        for (i = 0; i + length < wordCount; i++){
+            k = i + length;
+            int cell = cellIndex(i, k);
+            if (chart.insideScales[cell] == -numeric_limits<double>::infinity()){
+                continue;
+            }
+            maximum = -numeric_limits<double>::infinity();
+            for (j = k + 1; j < wordCount; j++){
+                maximum = max(maximum, chart.outsideScales[cellIndex(i, j)] + chart.insideScales[cellIndex(k + 1, j)]);
+            }
+            for (h = 0; h < i; h++){
+                maximum = max(maximum, chart.outsideScales[cellIndex(h, k)] + chart.insideScales[cellIndex(h, i - 1)]);
+            }
+            if (maximum == -numeric_limits<double>::infinity()){
+                continue;
+            }
+            double* childOutside = chart.outside.data() + (size_t) cell * nonTerminalCount;
+            const double* childInside = chart.inside.data() + (size_t) cell * nonTerminalCount;
+            for (j = k + 1; j < wordCount; j++){
+                scale = chart.outsideScales[cellIndex(i, j)] + chart.insideScales[cellIndex(k + 1, j)];
+                if (scale == -numeric_limits<double>::infinity()){
+                    continue;
+                }
+                double factor = exp(scale - maximum), countFactor = exp(scale + chart.insideScales[cell] - logSentence);
+                const double* parentOutside = chart.outside.data() + (size_t) cellIndex(i, j) * nonTerminalCount;
+                const double* right = chart.inside.data() + (size_t) cellIndex(k + 1, j) * nonTerminalCount;
+                for (B = 0; B < nonTerminalCount; B++){
+                    if (childInside[B] == 0.0){
+                        continue;
+                    }
+                    BinaryRuleBlock block = pCfg.getBinaryRulesWithLeftChild(B);
+                    double sum = 0.0;
+                    for (r = 0; r < block.size; r++){
+                        double term = binaryProbabilities[block.ruleIndexes[r]] * parentOutside[block.parents[r]] * right[block.rightChildren[r]];
+                        if (term != 0.0){
+                            sum += term;
+                            counts.binaryCounts[block.ruleIndexes[r]] += term * childInside[B] * countFactor;
+                        }
+                    }
+                    childOutside[B] += sum * factor;
+                }
+            }
+            for (h = 0; h < i; h++){
+                scale = chart.outsideScales[cellIndex(h, k)] + chart.insideScales[cellIndex(h, i - 1)];
+                if (scale == -numeric_limits<double>::infinity()){
+                    continue;
+                }
+                double factor = exp(scale - maximum);
+                const double* parentOutside = chart.outside.data() + (size_t) cellIndex(h, k) * nonTerminalCount;
+                const double* left = chart.inside.data() + (size_t) cellIndex(h, i - 1) * nonTerminalCount;
+                for (B = 0; B < nonTerminalCount; B++){
+                    if (left[B] == 0.0){
+                        continue;
+                    }
+                    BinaryRuleBlock block = pCfg.getBinaryRulesWithLeftChild(B);
+                    double leftFactor = left[B] * factor;
+                    for (r = 0; r < block.size; r++){
+                        childOutside[block.rightChildren[r]] += binaryProbabilities[block.ruleIndexes[r]] * parentOutside[block.parents[r]] * leftFactor;
+                    }
+                }
+            }
+            chart.outsideScales[cell] = maximum;
+            normalizeCell(childOutside, nonTerminalCount, chart.outsideScales[cell]);
+        }
+    }
+    for (i = 0; i < wordCount; i++){
+        int cell = cellIndex(i, i);
+        if (chart.outsideScales[cell] == -numeric_limits<double>::infinity()){
+            continue;
+        }
+        double countFactor = exp(chart.outsideScales[cell] - logSentence);
+        range = pCfg.getTerminalRuleRange(chart.wordSymbolIds[i]);
+        for (r = range.first; r < range.second; r++){
+            Rule* rule = pCfg.getTerminalRule(r);
+            counts.terminalCounts[r] += chart.outside[(size_t) cell * nonTerminalCount + rule->getLeftHandSideId()] * ((ProbabilisticRule*) rule)->getProbability() * countFactor;
+        }
+    }
+    counts.logLikelihood += logSentence;
+    counts.parsedCount++;
+}
+
+/**
+ * Runs one iteration of the inside-outside algorithm. In the expectation step, the sentences are split into
+ * contiguous shards, which the worker threads take from each other; every shard accumulates the expected counts of
+ * its sentences in its own buffers, and every worker reuses its own chart. The buffers are then added in shard order,
+ * so the result does not depend on the scheduling of the threads. In the maximization step, the probabilities of the
+ * rules are replaced with the relative frequencies of the expected counts. The grammar must be in Chomsky normal form
+ * without unary rules, since the inside and outside passes only use binary and terminal rules.
+ * @param pCfg Grammar whose rule probabilities are re-estimated.
+ * @return Log likelihood of the sentences having a derivation, under the grammar before the re-estimation.
+ * @throws invalid_argument if the grammar has rules which are neither binary nor terminal.
+ */
+double InsideOutsideTrainer::iterate(ProbabilisticContextFreeGrammar& pCfg){
+    int i, shards = max(1, min((int) sentences.size(), 4 * pool.getThreadCount()));
+    double logLikelihood = 0.0;
+    if (pCfg.hasUnaryRules() || pCfg.getBinaryRuleCount() + pCfg.getTerminalRuleCount() != pCfg.size()){
+        throw invalid_argument("InsideOutsideTrainer needs a grammar in Chomsky normal form without unary rules");
+    }
+    binaryProbabilities.resize(pCfg.getBinaryRuleCount());
+    for (i = 0; i < binaryProbabilities.size(); i++){
+        binaryProbabilities[i] = ((ProbabilisticRule*) pCfg.getBinaryRule(i))->getProbability();
+    }
+    shardCounts.resize(shards);
+    for (ExpectedCounts& counts : shardCounts){
+        counts.binaryCounts.assign(pCfg.getBinaryRuleCount(), 0.0);
+        counts.terminalCounts.assign(pCfg.getTerminalRuleCount(), 0.0);
+        counts.logLikelihood = 0.0;
+        counts.parsedCount = 0;
+    }
+    pool.parallelFor(shards, [&](int shard, int worker){
+        int first = (long long) sentences.size() * shard / shards, last = (long long) sentences.size() * (shard + 1) / shards;
+        for (int sentence = first; sentence < last; sentence++){
+            addExpectedCounts(pCfg, sentence, charts[worker], shardCounts[shard]);
+        }
+    });
+    parsedCount = 0;
+    ExpectedCounts& total = shardCounts[0];
+    for (int shard = 0; shard < shards; shard++){
+        if (shard > 0){
+            for (i = 0; i < total.binaryCounts.size(); i++){
+                total.binaryCounts[i] += shardCounts[shard].binaryCounts[i];
+            }
+            for (i = 0; i < total.terminalCounts.size(); i++){
+                total.terminalCounts[i] += shardCounts[shard].terminalCounts[i];
+            }
+        }
+        logLikelihood += shardCounts[shard].logLikelihood;
+        parsedCount += shardCounts[shard].parsedCount;
+    }
+    pCfg.reestimate(total.binaryCounts, total.terminalCounts);
+    return logLikelihood;
+}
+
+/**
+ * Re-estimates the rule probabilities of the grammar with the given number of inside-outside iterations. If a
+ * checkpoint file is set, the grammar is written to it after every iteration; it is first written to a temporary file
+ * which then replaces the checkpoint, so an interrupted write never destroys the previous checkpoint.
+ * @param pCfg Grammar in Chomsky normal form without unary rules, whose rule probabilities are re-estimated.
+ * @param iterationCount Number of iterations.
+ * @return Log likelihood of the sentences in the last iteration, before its re-estimation; minus infinity if a
+ * checkpoint can not be written, in which case the training stops.
+ * @throws invalid_argument if the grammar has rules which are neither binary nor terminal.
+ */
+double InsideOutsideTrainer::train(ProbabilisticContextFreeGrammar& pCfg, int iterationCount){
+    double logLikelihood = 0.0;
+    for (int iteration = 0; iteration < iterationCount; iteration++){
+        logLikelihood = iterate(pCfg);
+        if (!checkpointFileName.empty()){
+            string temporaryFileName = checkpointFileName + ".tmp";
+            if (!pCfg.saveBinary(temporaryFileName) || rename(temporaryFileName.c_str(), checkpointFileName.c_str()) != 0){
+                return -numeric_limits<double>::infinity();
+            }
+        }
+    }
+    return logLikelihood;
+}
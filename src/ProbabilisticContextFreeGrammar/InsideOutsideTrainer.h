@@ -0,0 +1,61 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#ifndef SYNTACTICPARSER_INSIDEOUTSIDETRAINER_H
+#define SYNTACTICPARSER_INSIDEOUTSIDETRAINER_H
+
+
+#include "ProbabilisticContextFreeGrammar.h"
+#include "../SyntacticParser/WorkStealingPool.h"
+
+/**
+ * Inside and outside probabilities of the spans of one sentence. The probabilities of a span are stored scaled, so
+ * that the largest one is 1, together with the logarithm of the scale, minus infinity if the span has no derivation.
+ */
+struct InsideOutsideChart {
+    vector<int> wordSymbolIds;
+    vector<char> allowed;
+    vector<double> inside;
+    vector<double> outside;
+    vector<double> insideScales;
+    vector<double> outsideScales;
+};
+
+/**
+ * Expected counts of the binary and terminal rules collected from a part of the sentences, together with the log
+ * likelihood of those sentences.
+ */
+struct ExpectedCounts {
+    vector<double> binaryCounts;
+    vector<double> terminalCounts;
+    double logLikelihood = 0.0;
+    int parsedCount = 0;
+};
+
+class InsideOutsideTrainer {
+private:
+    WorkStealingPool pool;
+    vector<InsideOutsideChart> charts;
+    vector<ExpectedCounts> shardCounts;
+    vector<double> binaryProbabilities;
+    vector<vector<string>> sentences;
+    vector<vector<pair<int, int>>> brackets;
+    string checkpointFileName;
+    int parsedCount = 0;
+    void addExpectedCounts(const ProbabilisticContextFreeGrammar& pCfg, int sentence, InsideOutsideChart& chart, ExpectedCounts& counts) const;
+    [[nodiscard]] static int cellIndex(int i, int j);
+public:
+    explicit InsideOutsideTrainer(int threadCount);
+    void addSentence(const Sentence* sentence);
+    void addSentence(const Sentence* sentence, const vector<pair<int, int>>& sentenceBrackets);
+    void addCorpus(const Corpus& corpus);
+    void setCheckpointFileName(const string& checkpointFileName);
+    [[nodiscard]] int sentenceCount() const;
+    [[nodiscard]] int getParsedCount() const;
+    double iterate(ProbabilisticContextFreeGrammar& pCfg);
+    double train(ProbabilisticContextFreeGrammar& pCfg, int iterationCount);
+};
+
+
+#endif //SYNTACTICPARSER_INSIDEOUTSIDETRAINER_H
@@ -5,8 +5,11 @@
 #include "ProbabilisticContextFreeGrammar.h"
 
 #include <algorithm>
+#include <limits>
+#include <stdexcept>
 
 #include "ProbabilisticRule.h"
+#include "../SyntacticParser/WorkStealingPool.h"
 
 /**
  * Constructor for the ProbabilisticContextFreeGrammar class. Reads the rules from the rule file, lexicon rules from
@@ -23,6 +26,9 @@ ProbabilisticContextFreeGrammar::ProbabilisticContextFreeGrammar(const string& r
     inputFile.open(ruleFileName, ifstream :: in);
     while (inputFile.good()) {
         getline(inputFile, line);
+        if (line.find("->") == string::npos){
+            continue;
+        }
         Rule* newRule = new ProbabilisticRule(line);
         rules.emplace_back(newRule);
         rulesRightSorted.emplace_back(newRule);
@@ -32,9 +38,69 @@ ProbabilisticContextFreeGrammar::ProbabilisticContextFreeGrammar(const string& r
     ranges::sort(rulesRightSorted, compareRuleRight);
     readDictionary(dictionaryFileName);
     updateTypes();
+    updateSymbolIds();
+    updateRuleIndex();
     this->minCount = minCount;
 }
 
+/**
+ * Another constructor for the ProbabilisticContextFreeGrammar class. Induces the same grammar as the serial treebank
+ * constructor with a pool of threads: the treebank is split into contiguous shards, every shard builds its own lexicon
+ * and its own rule counts, and the shards are merged in shard order. Since the counts are integers, the merged counts,
+ * and so the probabilities normalized once from them, are exactly those of the serial constructor.
+ * @param treeBank Treebank containing the constituency trees.
+ * @param minCount Minimum frequency parameter.
+ * @param threadCount Number of threads. If it is not positive, the number of hardware threads is used.
+ */
+ProbabilisticContextFreeGrammar::ProbabilisticContextFreeGrammar(const TreeBank &treeBank, int minCount, int threadCount) {
+    WorkStealingPool pool(threadCount);
+    unordered_map<string, int> totals;
+    constructDictionary(treeBank, pool);
+    int shards = shardCount(treeBank, pool);
+    vector<RuleSet> shardRules(shards);
+    pool.parallelFor(shards, [&](int shard, int worker){
+        auto [first, last] = shardRange(treeBank, shards, shard);
+        for (int i = first; i < last; i++){
+            ParseTree* parseTree = treeBank.get(i);
+            updateTree(parseTree, minCount);
+            addRules(parseTree->getRoot(), shardRules[shard]);
+        }
+    });
+    RuleSet inducedRules;
+    for (const RuleSet& ruleSet : shardRules){
+        for (Rule* rule : ruleSet){
+            auto [existedRule, inserted] = inducedRules.emplace(rule);
+            if (!inserted){
+                ((ProbabilisticRule*) *existedRule)->increment(((ProbabilisticRule*) rule)->getCount());
+                delete rule;
+            }
+        }
+    }
+    for (Rule* rule : inducedRules){
+        totals[rule->getLeftHandSide().getName()] += ((ProbabilisticRule*) rule)->getCount();
+    }
+    for (Rule* rule : inducedRules){
+        ((ProbabilisticRule*) rule)->normalizeProbability(totals[rule->getLeftHandSide().getName()]);
+    }
+    setRules(vector<Rule*>(inducedRules.begin(), inducedRules.end()));
+    updateTypes();
+    updateSymbolIds();
+    updateRuleIndex();
+    this->minCount = minCount;
+}
+
+/**
+ * Another constructor for the ProbabilisticContextFreeGrammar class. Loads a grammar compiled with saveBinary from a
+ * probabilistic grammar, with the probabilities of its rules.
+ * @param binaryFileName File name of the compiled grammar.
+ * @throws invalid_argument If the file can not be read, or is not a valid compiled probabilistic grammar.
+ */
+ProbabilisticContextFreeGrammar::ProbabilisticContextFreeGrammar(const string &binaryFileName) {
+    if (!loadBinary(binaryFileName)){
+        throw invalid_argument("Can not load the compiled grammar " + binaryFileName);
+    }
+}
+
 /**
  * Another constructor for the ProbabilisticContextFreeGrammar class. Constructs the lexicon from the leaf nodes of
  * the trees in the given treebank. Extracts rules from the non-leaf nodes of the trees in the given treebank. Also
@@ -43,28 +109,74 @@ ProbabilisticContextFreeGrammar::ProbabilisticContextFreeGrammar(const string& r
  * @param minCount Minimum frequency parameter.
  */
 ProbabilisticContextFreeGrammar::ProbabilisticContextFreeGrammar(const TreeBank& treeBank, int minCount){
-    vector<Symbol> variables;
-    vector<Rule*> candidates;
-    int total;
+    RuleSet inducedRules;
+    unordered_map<string, int> totals;
     constructDictionary(treeBank);
     for (int i = 0; i < treeBank.size(); i++){
         ParseTree* parseTree = treeBank.get(i);
         updateTree(parseTree, minCount);
-        addRules(parseTree->getRoot());
-    }
-    variables = getLeftSide();
-    for (const Symbol& variable: variables){
-        candidates = getRulesWithLeftSideX(variable);
-        total = 0;
-        for (Rule* candidate: candidates){
-            total += ((ProbabilisticRule*)candidate)->getCount();
+        addRules(parseTree->getRoot(), inducedRules);
+    }
+    for (Rule* rule : inducedRules){
+        totals[rule->getLeftHandSide().getName()] += ((ProbabilisticRule*) rule)->getCount();
+    }
+    for (Rule* rule : inducedRules){
+        ((ProbabilisticRule*) rule)->normalizeProbability(totals[rule->getLeftHandSide().getName()]);
+    }
+    setRules(vector<Rule*>(inducedRules.begin(), inducedRules.end()));
+    updateTypes();
+    updateSymbolIds();
+    updateRuleIndex();
+    this->minCount = minCount;
+}
+
+/**
+ * Constructs a coarse grammar by projecting the non-terminals of a fine grammar onto a smaller set of classes. Every
+ * rule of the fine grammar is mapped to the rule of the classes of its symbols; the probability of a coarse rule is
+ * the maximum probability of the fine rules mapped to it, so the best coarse derivation of a span is never less
+ * probable than the best fine derivation. The lexicon and the minimum frequency parameter are copied from the fine
+ * grammar.
+ * @param fineGrammar Grammar whose non-terminals are projected.
+ * @param projection Class name of every non-terminal of the fine grammar, indexed by the non-terminal ids.
+ */
+ProbabilisticContextFreeGrammar::ProbabilisticContextFreeGrammar(const ProbabilisticContextFreeGrammar& fineGrammar, const vector<string>& projection){
+    unordered_map<string, ProbabilisticRule*> coarseRules;
+    for (Rule* rule : fineGrammar.rules){
+        Symbol left = Symbol(projection[rule->getLeftHandSideId()]);
+        vector<Symbol> right;
+        string key = left.getName() + " ->";
+        for (int i = 0; i < rule->getRightHandSideSize(); i++){
+            int symbolId = rule->getRightHandSideIdAt(i);
+            if (symbolId < fineGrammar.nonTerminalCount){
+                right.emplace_back(projection[symbolId]);
+            } else {
+                right.emplace_back(rule->getRightHandSideAt(i));
+            }
+            key += " " + right.back().getName();
         }
-        for (Rule* candidate: candidates){
-            ((ProbabilisticRule*) candidate)->normalizeProbability(total);
+        double probability = ((ProbabilisticRule*) rule)->getProbability();
+        auto found = coarseRules.find(key);
+        if (found != coarseRules.end()){
+            if (probability > found->second->getProbability()){
+                auto* coarseRule = new ProbabilisticRule(left, right, rule->getRuleType(), probability);
+                replace(rules.begin(), rules.end(), (Rule*) found->second, (Rule*) coarseRule);
+                delete found->second;
+                found->second = coarseRule;
+            }
+        } else {
+            auto* coarseRule = new ProbabilisticRule(left, right, rule->getRuleType(), probability);
+            coarseRules.emplace(key, coarseRule);
+            rules.emplace_back(coarseRule);
         }
     }
+    rulesRightSorted = rules;
+    ranges::sort(rules, compareRuleLeft);
+    ranges::sort(rulesRightSorted, compareRuleRight);
+    dictionary = fineGrammar.dictionary;
+    minCount = fineGrammar.minCount;
     updateTypes();
-    this->minCount = minCount;
+    updateSymbolIds();
+    updateRuleIndex();
 }
 
 /**
@@ -94,24 +206,23 @@ ProbabilisticRule* ProbabilisticContextFreeGrammar::toRule(const ParseNode* pars
 }
 
 /**
- * Recursive method to generate all rules from a subtree rooted at the given node.
+ * Recursive method to generate all rules from a subtree rooted at the given node. The rules are counted in a hash set
+ * keyed on the whole rule, so that every occurrence of a rule increments the count of its single copy.
  * @param parseNode Root node of the subtree.
+ * @param inducedRules Distinct rules generated so far, with their counts.
  */
-void ProbabilisticContextFreeGrammar::addRules(const ParseNode* parseNode){
-    Rule* existedRule;
+void ProbabilisticContextFreeGrammar::addRules(const ParseNode* parseNode, RuleSet& inducedRules){
     ProbabilisticRule* newRule;
     newRule = toRule(parseNode, true);
-    existedRule = searchRule(newRule);
-    if (existedRule == nullptr){
-        addRule(newRule);
-        newRule->increment();
-    } else {
-        ((ProbabilisticRule*) existedRule)->increment();
+    auto [existedRule, inserted] = inducedRules.emplace(newRule);
+    ((ProbabilisticRule*) *existedRule)->increment();
+    if (!inserted){
+        delete newRule;
     }
     for (int i = 0; i < parseNode->numberOfChildren(); i++) {
         ParseNode* childNode = parseNode->getChild(i);
         if (childNode->numberOfChildren() > 0){
-            addRules(childNode);
+            addRules(childNode, inducedRules);
         }
     }
 }
@@ -119,7 +230,7 @@ void ProbabilisticContextFreeGrammar::addRules(const ParseNode* parseNode){
 /**
  * Calculates the probability of a parse node.
  * @param parseNode Parse node for which probability is calculated.
- * @return Probability of a parse node.
+ * @return Logarithm of the probability of a parse node, -infinity if the grammar does not contain one of its rules.
  */
 double ProbabilisticContextFreeGrammar::probability(const ParseNode* parseNode){
     Rule* existedRule;
@@ -128,7 +239,11 @@ double ProbabilisticContextFreeGrammar::probability(const ParseNode* parseNode){
     if (parseNode->numberOfChildren() > 0){
         rule = toRule(parseNode, true);
         existedRule = searchRule(rule);
-        sum = log(((ProbabilisticRule*)existedRule)->getProbability());
+        delete rule;
+        if (existedRule == nullptr){
+            return -numeric_limits<double>::infinity();
+        }
+        sum = ((ProbabilisticRule*) existedRule)->getLogProbability();
         if (existedRule->getRuleType() != RuleType::TERMINAL){
             for (int i = 0; i < parseNode->numberOfChildren(); i++){
                 ParseNode* childNode = parseNode->getChild(i);
@@ -149,67 +264,227 @@ double ProbabilisticContextFreeGrammar::probability(const ParseTree* parseTree){
 }
 
 /**
- * In conversion to Chomsky Normal Form, rules like X -> Y are removed and new rules for every rule as Y -> beta are
- * replaced with X -> beta. The method first identifies all X -> Y rules. For every such rule, all rules Y -> beta
- * are identified. For every such rule, the method adds a new rule X -> beta. Every Y -> beta rule is then deleted.
- * The method also calculates the probability of the new rules based on the previous rules.
- */
-void ProbabilisticContextFreeGrammar::removeSingleNonTerminalFromRightHandSide(){
-    vector<Symbol> nonTerminalList;
-    Symbol removeCandidate;
-    vector<Rule*> ruleList;
-    vector<Rule*> candidateList;
-    removeCandidate = getSingleNonTerminalCandidateToRemove(nonTerminalList);
-    while (!removeCandidate.getName().empty()){
-        ruleList = getRulesWithRightSideX(removeCandidate);
-        for (Rule* rule: ruleList){
-            candidateList = getRulesWithLeftSideX(removeCandidate);
-            for (Rule* candidate: candidateList){
-                vector<Symbol> clone;
-                for (const Symbol& symbol: candidate->getRightHandSide()){
-                    clone.emplace_back(symbol.getName());
+ * Updates the rule lookups of the grammar. In addition to the lookups of ContextFreeGrammar, the binary rules with two
+ * non-terminals on the right hand side are stored as parallel arrays of right children, parents, log probabilities
+ * and positions in the binary rule index, grouped by their left child. The parsers score all rules of a left child
+ * with vector loads from these arrays.
+ */
+void ProbabilisticContextFreeGrammar::updateRuleLookups() {
+    ContextFreeGrammar::updateRuleLookups();
+    leftChildOffsets.assign(nonTerminalCount + 1, 0);
+    binaryRightChildren.clear();
+    binaryParents.clear();
+    binaryLogProbabilities.clear();
+    binaryRuleIndexes.clear();
+    for (int i = 0; i < binaryRules.size(); i++){
+        Rule* rule = binaryRules[i];
+        if (rule->getRightHandSideIdAt(0) < nonTerminalCount && rule->getRightHandSideIdAt(1) < nonTerminalCount){
+            leftChildOffsets[rule->getRightHandSideIdAt(0) + 1]++;
+            binaryRightChildren.emplace_back(rule->getRightHandSideIdAt(1));
+            binaryParents.emplace_back(rule->getLeftHandSideId());
+            binaryLogProbabilities.emplace_back(((ProbabilisticRule*) rule)->getLogProbability());
+            binaryRuleIndexes.emplace_back(i);
+        }
+    }
+    for (int i = 1; i < leftChildOffsets.size(); i++){
+        leftChildOffsets[i] += leftChildOffsets[i - 1];
+    }
+    updateEstimates();
+}
+
+/**
+ * Replaces the probabilities of the binary and terminal rules with their relative frequencies in the given expected
+ * counts, as in the maximization step of the inside-outside algorithm: the probability of a rule X -> ... is its count
+ * divided by the total count of the rules of X. The rules of a non-terminal without any count keep their
+ * probabilities. The lookups of the parsers are rebuilt with the new probabilities. Only binary and terminal rules have
+ * counts, so the grammar must be in Chomsky normal form without unary rules; otherwise the distributions of the
+ * non-terminals with other rules would no longer sum to one.
+ * @param binaryCounts Expected count of every binary rule, indexed by the positions in the binary rule index.
+ * @param terminalCounts Expected count of every terminal rule, indexed by the positions in the terminal rule index.
+ * @throws invalid_argument if the grammar has rules which are neither binary nor terminal.
+ */
+void ProbabilisticContextFreeGrammar::reestimate(const vector<double>& binaryCounts, const vector<double>& terminalCounts) {
+    if (hasUnaryRules() || binaryRules.size() + terminalRules.size() != rules.size()){
+        throw invalid_argument("Only a grammar in Chomsky normal form without unary rules can be re-estimated");
+    }
+    vector<double> totals(nonTerminalCount, 0.0);
+    for (int i = 0; i < binaryRules.size(); i++){
+        totals[binaryRules[i]->getLeftHandSideId()] += binaryCounts[i];
+    }
+    for (int i = 0; i < terminalRules.size(); i++){
+        totals[terminalRules[i]->getLeftHandSideId()] += terminalCounts[i];
+    }
+    for (int i = 0; i < binaryRules.size(); i++){
+        if (totals[binaryRules[i]->getLeftHandSideId()] > 0){
+            ((ProbabilisticRule*) binaryRules[i])->setProbability(binaryCounts[i] / totals[binaryRules[i]->getLeftHandSideId()]);
+        }
+    }
+    for (int i = 0; i < terminalRules.size(); i++){
+        if (totals[terminalRules[i]->getLeftHandSideId()] > 0){
+            ((ProbabilisticRule*) terminalRules[i])->setProbability(terminalCounts[i] / totals[terminalRules[i]->getLeftHandSideId()]);
+        }
+    }
+    updateRuleLookups();
+}
+
+/**
+ * Creates a probabilistic rule while loading a compiled grammar or converting the grammar into Chomsky normal form.
+ * @param leftHandSide Left hand side symbol of the rule.
+ * @param rightHandSide Right hand side symbols of the rule.
+ * @param type Type of the rule.
+ * @param probability Probability of the rule.
+ * @return New probabilistic rule.
+ */
+Rule *ProbabilisticContextFreeGrammar::createRule(const Symbol &leftHandSide, const vector<Symbol> &rightHandSide, RuleType type, double probability) const {
+    return new ProbabilisticRule(leftHandSide, rightHandSide, type, probability);
+}
+
+/**
+ * Returns the probability of a rule of this grammar to be stored in a compiled grammar.
+ * @param rule Rule of the grammar.
+ * @return Probability of the rule.
+ */
+double ProbabilisticContextFreeGrammar::ruleProbability(const Rule *rule) const {
+    return ((const ProbabilisticRule*) rule)->getProbability();
+}
+
+/**
+ * Returns the log probability of a rule of this grammar, used in choosing the best chains of the unary closure.
+ * @param rule Rule of the grammar.
+ * @return Log probability of the rule.
+ */
+double ProbabilisticContextFreeGrammar::ruleLogProbability(const Rule *rule) const {
+    return ((const ProbabilisticRule*) rule)->getLogProbability();
+}
+
+/**
+ * Checks if the grammar is probabilistic, which is stored in the header of a compiled grammar.
+ * @return True.
+ */
+bool ProbabilisticContextFreeGrammar::isProbabilistic() const {
+    return true;
+}
+
+/**
+ * Computes the label-only inside and outside estimates of the non-terminals. The inside estimate of a non-terminal is
+ * the log probability of its most probable derivation of any word sequence; the outside estimate is the log
+ * probability of the most probable context of the non-terminal below the start symbol, i.e. of the rules and the
+ * sibling derivations of a tree in which it appears. Both are upper bounds independent of the sentence, so adding
+ * the outside estimate to the log probability of a partial parse never underestimates the best complete parse
+ * containing it. Both are computed by relaxing all rules until no estimate improves.
+ */
+void ProbabilisticContextFreeGrammar::updateEstimates() {
+    bool changed = true;
+    int iteration, i, j;
+    insideEstimates.assign(symbols.size(), 0.0);
+    outsideEstimates.assign(nonTerminalCount, -numeric_limits<double>::infinity());
+    for (i = 0; i < nonTerminalCount; i++){
+        insideEstimates[i] = -numeric_limits<double>::infinity();
+    }
+    for (iteration = 0; changed && iteration <= symbols.size(); iteration++){
+        changed = false;
+        for (Rule* rule : rules){
+            double score = ((ProbabilisticRule*) rule)->getLogProbability();
+            for (i = 0; i < rule->getRightHandSideSize(); i++){
+                score += insideEstimates[rule->getRightHandSideIdAt(i)];
+            }
+            if (score > insideEstimates[rule->getLeftHandSideId()]){
+                insideEstimates[rule->getLeftHandSideId()] = score;
+                changed = true;
+            }
+        }
+    }
+    if (startSymbolId == -1 || startSymbolId >= nonTerminalCount){
+        return;
+    }
+    outsideEstimates[startSymbolId] = 0.0;
+    changed = true;
+    for (iteration = 0; changed && iteration <= symbols.size(); iteration++){
+        changed = false;
+        for (Rule* rule : rules){
+            double outside = outsideEstimates[rule->getLeftHandSideId()];
+            if (outside == -numeric_limits<double>::infinity()){
+                continue;
+            }
+            outside += ((ProbabilisticRule*) rule)->getLogProbability();
+            for (i = 0; i < rule->getRightHandSideSize(); i++){
+                int child = rule->getRightHandSideIdAt(i);
+                if (child >= nonTerminalCount){
+                    continue;
+                }
+                double score = outside;
+                for (j = 0; j < rule->getRightHandSideSize(); j++){
+                    if (j != i){
+                        score += insideEstimates[rule->getRightHandSideIdAt(j)];
+                    }
+                }
+                if (score > outsideEstimates[child]){
+                    outsideEstimates[child] = score;
+                    changed = true;
                 }
-                addRule(new ProbabilisticRule(rule->getLeftHandSide(),
-                                              clone,
-                                              candidate->getRuleType(),
-                                              ((ProbabilisticRule*) rule)->getProbability() * ((ProbabilisticRule*) candidate)->getProbability()));
             }
-            removeRule(rule);
         }
-        nonTerminalList.emplace_back(removeCandidate);
-        removeCandidate = getSingleNonTerminalCandidateToRemove(nonTerminalList);
     }
 }
 
 /**
- * In conversion to Chomsky Normal Form, rules like A -> BC... are replaced with A -> X1... and X1 -> BC. This
- * method determines such rules and for every such rule, it adds new rule X1->BC and updates rule A->BC to A->X1.
- * The method sets the probability of the rules X1->BC to 1, and calculates the probability of the rules A -> X1...
+ * Returns the binary rules with the given non-terminal as the left child on the right hand side, as parallel arrays.
+ * The rules are sorted by their right child and then by their parent.
+ * @param leftSymbolId Id of the left child.
+ * @return Right children, parents, log probabilities and positions in the binary rule index of the rules.
  */
-void ProbabilisticContextFreeGrammar::updateMultipleNonTerminalFromRightHandSide(){
-    Rule* updateCandidate;
-    int newVariableCount = 0;
-    updateCandidate = getMultipleNonTerminalCandidateToUpdate();
-    while (updateCandidate != nullptr){
-        vector<Symbol> newRightHandSide;
-        Symbol newSymbol = Symbol("X" + to_string(newVariableCount));
-        newRightHandSide.emplace_back(updateCandidate->getRightHandSide()[0]);
-        newRightHandSide.emplace_back(updateCandidate->getRightHandSide()[1]);
-        updateAllMultipleNonTerminalWithNewRule(updateCandidate->getRightHandSide()[0], updateCandidate->getRightHandSide()[1], newSymbol);
-        addRule(new ProbabilisticRule(newSymbol, newRightHandSide, RuleType::TWO_NON_TERMINAL, 1.0));
-        updateCandidate = getMultipleNonTerminalCandidateToUpdate();
-        newVariableCount++;
+BinaryRuleBlock ProbabilisticContextFreeGrammar::getBinaryRulesWithLeftChild(int leftSymbolId) const {
+    if (leftSymbolId < 0 || leftSymbolId >= nonTerminalCount){
+        return {nullptr, nullptr, nullptr, nullptr, 0};
     }
+    int start = leftChildOffsets[leftSymbolId];
+    return {binaryRightChildren.data() + start, binaryParents.data() + start, binaryLogProbabilities.data() + start, binaryRuleIndexes.data() + start, leftChildOffsets[leftSymbolId + 1] - start};
 }
 
 /**
- * The method converts the grammar into Chomsky normal form. First, rules like X -> Y are removed and new rules for
- * every rule as Y -> beta are replaced with X -> beta. Second, rules like A -> BC... are replaced with A -> X1...
- * and X1 -> BC.
+ * Returns the log probability of the most probable derivation of the given symbol, over any word sequence.
+ * @param symbolId Id of the symbol.
+ * @return Inside estimate of the symbol, 0 for a terminal.
  */
-void ProbabilisticContextFreeGrammar::convertToChomskyNormalForm(){
-    removeSingleNonTerminalFromRightHandSide();
-    updateMultipleNonTerminalFromRightHandSide();
-    ranges::sort(rules, compareRuleLeft);
-    ranges::sort(rulesRightSorted, compareRuleRight);
+double ProbabilisticContextFreeGrammar::getInsideEstimate(int symbolId) const {
+    return insideEstimates[symbolId];
+}
+
+/**
+ * Returns the log probability of the most probable context of the given non-terminal below the start symbol.
+ * @param symbolId Id of the non-terminal.
+ * @return Outside estimate of the non-terminal, minus infinity if it can not appear below the start symbol.
+ */
+double ProbabilisticContextFreeGrammar::getOutsideEstimate(int symbolId) const {
+    return outsideEstimates[symbolId];
+}
+
+/**
+ * Accessor for the outside estimates of all non-terminals.
+ * @return Outside estimates indexed by the non-terminal ids.
+ */
+const vector<double>& ProbabilisticContextFreeGrammar::getOutsideEstimates() const {
+    return outsideEstimates;
+}
+
+/**
+ * Returns the projection of the non-terminals onto their label families: the binarization symbols X1, X2, ... of the
+ * Chomsky normal form are merged into X, and the functional tags are stripped, so that NP-SBJ and NP=2 become NP.
+ * @return Class name of every non-terminal, indexed by the non-terminal ids.
+ */
+vector<string> ProbabilisticContextFreeGrammar::labelFamilyProjection() const {
+    vector<string> projection;
+    for (int i = 0; i < nonTerminalCount; i++){
+        string name = symbols[i].getName();
+        if (name.size() > 1 && name[0] == 'X' && all_of(name.begin() + 1, name.end(), [](char c){ return isdigit((unsigned char) c); })){
+            name = "X";
+        } else {
+            size_t tag = name.find_first_of("-=", 1);
+            if (tag != string::npos && name[name.size() - 1] != '-'){
+                name = name.substr(0, tag);
+            }
+        }
+        projection.emplace_back(name);
+    }
+    return projection;
 }
\ No newline at end of file
@@ -9,21 +9,49 @@
 #include "../ContextFreeGrammar/ContextFreeGrammar.h"
 #include "../ProbabilisticContextFreeGrammar/ProbabilisticRule.h"
 
+struct BinaryRuleBlock {
+    const int* rightChildren;
+    const int* parents;
+    const double* logProbabilities;
+    const int* ruleIndexes;
+    int size;
+};
+
 class ProbabilisticContextFreeGrammar : public ContextFreeGrammar{
+protected:
+    vector<int> leftChildOffsets;
+    vector<int> binaryRightChildren;
+    vector<int> binaryParents;
+    vector<double> binaryLogProbabilities;
+    vector<int> binaryRuleIndexes;
+    vector<double> insideEstimates;
+    vector<double> outsideEstimates;
+    void updateRuleLookups() override;
+    [[nodiscard]] Rule* createRule(const Symbol& leftHandSide, const vector<Symbol>& rightHandSide, RuleType type, double probability) const override;
+    [[nodiscard]] double ruleProbability(const Rule* rule) const override;
+    [[nodiscard]] double ruleLogProbability(const Rule* rule) const override;
+    [[nodiscard]] bool isProbabilistic() const override;
+    void updateEstimates();
 public:
     ProbabilisticContextFreeGrammar() = default;
     ProbabilisticContextFreeGrammar(const string& ruleFileName,
                                     const string& dictionaryFileName,
                                     int minCount);
     ProbabilisticContextFreeGrammar(const TreeBank& treeBank, int minCount);
+    ProbabilisticContextFreeGrammar(const TreeBank& treeBank, int minCount, int threadCount);
+    explicit ProbabilisticContextFreeGrammar(const string& binaryFileName);
+    ProbabilisticContextFreeGrammar(const ProbabilisticContextFreeGrammar& fineGrammar, const vector<string>& projection);
     static ProbabilisticRule* toRule(const ParseNode* parseNode, bool trim);
     double probability(const ParseTree* parseTree);
-    void convertToChomskyNormalForm();
+    [[nodiscard]] vector<string> labelFamilyProjection() const;
+    void reestimate(const vector<double>& binaryCounts, const vector<double>& terminalCounts);
+    [[nodiscard]] BinaryRuleBlock getBinaryRulesWithLeftChild(int leftSymbolId) const;
+    [[nodiscard]] double getInsideEstimate(int symbolId) const;
+    [[nodiscard]] double getOutsideEstimate(int symbolId) const;
+    [[nodiscard]] const vector<double>& getOutsideEstimates() const;
 private:
-    void addRules(const ParseNode* parseNode);
+    void addRules(const ParseNode* parseNode, RuleSet& inducedRules);
     double probability(const ParseNode* parseNode);
-    void removeSingleNonTerminalFromRightHandSide();
-    void updateMultipleNonTerminalFromRightHandSide();
 };
 
 
@@ -3,6 +3,7 @@
 //
 
 #include "ProbabilisticRule.h"
+#include <cmath>
 #include <StringUtils.h>
 
 /**
@@ -23,7 +24,7 @@ ProbabilisticRule::ProbabilisticRule(const Symbol &leftHandSide, const vector<Sy
  */
 ProbabilisticRule::ProbabilisticRule(const Symbol &leftHandSide, const vector<Symbol> &rightHandSide, RuleType type,
                                      double probability): Rule(leftHandSide, rightHandSide, type) {
-    this->probability = probability;
+    setProbability(probability);
 }
 
 /**
@@ -36,11 +37,12 @@ ProbabilisticRule::ProbabilisticRule(const string& rule){
     string left = StringUtils::trim(rule.substr(0, rule.find("->")));
     string right = StringUtils::trim(rule.substr(rule.find("->") + 2, rule.find('[') - rule.find("->") - 2));
     leftHandSide = Symbol(left);
+    rightHandSide.clear();
     vector<string> rightSide = StringUtils::split(right, " ");
     for (const string& s : rightSide){
         rightHandSide.emplace_back(s);
     }
-    probability = stod(prob);
+    setProbability(stod(prob));
 }
 
 /**
@@ -51,6 +53,24 @@ double ProbabilisticRule::getProbability() const{
     return probability;
 }
 
+/**
+ * Accessor for the logarithm of the probability of the rule. It is computed once whenever the probability changes,
+ * so that the parsers do not compute a logarithm for every candidate.
+ * @return Logarithm of the probability of the rule.
+ */
+double ProbabilisticRule::getLogProbability() const{
+    return logProbability;
+}
+
+/**
+ * Sets the probability of the rule, and updates its logarithm.
+ * @param probability New probability of the rule.
+ */
+void ProbabilisticRule::setProbability(double probability){
+    this->probability = probability;
+    this->logProbability = log(probability);
+}
+
 /**
  * Increments the count attribute.
  */
@@ -58,12 +78,21 @@ void ProbabilisticRule::increment(){
     count++;
 }
 
+/**
+ * Increments the count attribute by the given amount, such as the count of the same rule in another part of a
+ * treebank.
+ * @param amount Amount to be added to the count.
+ */
+void ProbabilisticRule::increment(int amount){
+    count += amount;
+}
+
 /**
  * Calculates the probability from count and the given total value.
  * @param total Value used for calculating the probability.
  */
 void ProbabilisticRule::normalizeProbability(int total) {
-    probability = count / (total + 0.0);
+    setProbability(count / (total + 0.0));
 }
 
 /**
@@ -6,18 +6,23 @@
 #define SYNTACTICPARSER_PROBABILISTICRULE_H
 
 
+#include <limits>
 #include "../ContextFreeGrammar/Rule.h"
 
 class ProbabilisticRule : public Rule{
 private:
     double probability = 0.0;
+    double logProbability = -numeric_limits<double>::infinity();
     int count = 0;
 public:
     ProbabilisticRule(const Symbol& leftHandSide, const vector<Symbol>& rightHandSide);
     ProbabilisticRule(const Symbol& leftHandSide, const vector<Symbol>& rightHandSide, RuleType type, double probability);
     explicit ProbabilisticRule(const string& rule);
     [[nodiscard]] double getProbability() const;
+    [[nodiscard]] double getLogProbability() const;
+    void setProbability(double probability);
     void increment();
+    void increment(int amount);
     void normalizeProbability(int total);
     [[nodiscard]] int getCount() const;
     [[nodiscard]] string to_string() const;
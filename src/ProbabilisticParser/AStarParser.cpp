@@ -0,0 +1,200 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include <limits>
+#include <stdexcept>
+#include "AStarParser.h"
+#include "../ProbabilisticContextFreeGrammar/ProbabilisticParseNode.h"
+
+/**
+ * Offers a derivation to the agenda. The priority of an edge is its log probability plus the outside estimate of its
+ * non-terminal, an upper bound of the log probability of the best context of the non-terminal precomputed from the
+ * grammar. Edges whose non-terminal can not appear below the start symbol are dropped. If the edge was already
+ * offered, it is only offered again with a more probable derivation, and never after it is popped.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param wordCount Number of words in the sentence.
+ * @param edge Derivation of a non-terminal over a span.
+ */
+void AStarParser::offer(const ProbabilisticContextFreeGrammar& pCfg, int wordCount, const AStarEdge& edge){
+    double estimate = pCfg.getOutsideEstimate(edge.symbolId);
+    if (estimate == -numeric_limits<double>::infinity()){
+        return;
+    }
+    long long key = ((long long) (edge.start * wordCount + edge.end) << 32) | edge.symbolId;
+    auto [position, inserted] = edgeIndexes.emplace(key, edges.size());
+    if (inserted){
+        edges.emplace_back(edge);
+    } else {
+        AStarEdge& existing = edges[position->second];
+        if (existing.finished || edge.logProbability <= existing.logProbability){
+            return;
+        }
+        existing = edge;
+    }
+    agenda.emplace(edge.logProbability + estimate, position->second);
+}
+
+/**
+ * Combines a popped edge with the popped edges adjacent to it: as the left child of the binary rules with the edges
+ * starting right after it, and as the right child with the edges ending right before it. If the grammar keeps unary
+ * rules, the chains of the unary closure of its non-terminal are offered over the same span; a chain edge is not
+ * extended again, since the closure of the edge at its bottom already contains the best chains above it.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param wordCount Number of words in the sentence.
+ * @param index Index of the popped edge.
+ */
+void AStarParser::combine(const ProbabilisticContextFreeGrammar& pCfg, int wordCount, int index){
+    AStarEdge edge = edges[index];
+    pair<int, int> range;
+    if (pCfg.hasUnaryRules() && edge.right != -2){
+        range = pCfg.getUnaryClosureRange(edge.symbolId);
+        for (int e = range.first; e < range.second; e++){
+            const UnaryClosureEntry& entry = pCfg.getUnaryClosureEntry(e);
+            offer(pCfg, wordCount, {edge.start, edge.end, entry.symbolId, edge.logProbability + entry.logProbability, index, -2, e, false});
+        }
+    }
+    if (edge.end + 1 < wordCount){
+        for (int right : startingAt[edge.end + 1]){
+            int end = edges[right].end;
+            double logProbability = edge.logProbability + edges[right].logProbability;
+            range = pCfg.getBinaryRuleRange(edge.symbolId, edges[right].symbolId);
+            for (int r = range.first; r < range.second; r++){
+                Rule* rule = pCfg.getBinaryRule(r);
+                offer(pCfg, wordCount, {edge.start, end, rule->getLeftHandSideId(), logProbability + ((ProbabilisticRule*) rule)->getLogProbability(), index, right, r, false});
+            }
+        }
+    }
+    if (edge.start > 0){
+        for (int left : endingAt[edge.start - 1]){
+            int start = edges[left].start;
+            double logProbability = edges[left].logProbability + edge.logProbability;
+            range = pCfg.getBinaryRuleRange(edges[left].symbolId, edge.symbolId);
+            for (int r = range.first; r < range.second; r++){
+                Rule* rule = pCfg.getBinaryRule(r);
+                offer(pCfg, wordCount, {start, edge.end, rule->getLeftHandSideId(), logProbability + ((ProbabilisticRule*) rule)->getLogProbability(), left, index, r, false});
+            }
+        }
+    }
+    startingAt[edge.start].emplace_back(index);
+    endingAt[edge.end].emplace_back(index);
+}
+
+/**
+ * Constructs the subtree of the derivation of the given edge by following the edges of its children.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param words Words of the sentence, the leaves of the tree.
+ * @param index Index of the edge at the root of the subtree.
+ * @return Root of the subtree of the derivation.
+ */
+ParseNode* AStarParser::constructTree(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words, int index) const{
+    const AStarEdge& edge = edges[index];
+    if (edge.right == -1){
+        return new ProbabilisticParseNode(new ParseNode(Symbol(words[edge.start])), pCfg.getSymbol(edge.symbolId), edge.logProbability);
+    }
+    if (edge.right == -2){
+        vector<int> chain;
+        for (int entry = edge.rule; entry != -1; entry = pCfg.getUnaryClosureEntry(entry).below){
+            chain.emplace_back(entry);
+        }
+        ParseNode* node = constructTree(pCfg, words, edge.left);
+        for (int k = chain.size() - 1; k >= 0; k--){
+            const UnaryClosureEntry& entry = pCfg.getUnaryClosureEntry(chain[k]);
+            node = new ProbabilisticParseNode(node, pCfg.getSymbol(entry.symbolId), edges[edge.left].logProbability + entry.logProbability);
+        }
+        return node;
+    }
+    ParseNode* left = constructTree(pCfg, words, edge.left);
+    ParseNode* right = constructTree(pCfg, words, edge.right);
+    return new ProbabilisticParseNode(left, right, pCfg.getSymbol(edge.symbolId), edge.logProbability);
+}
+
+/**
+ * Accessor for the number of edges popped from the agenda while parsing the last sentence.
+ * @return Number of popped edges.
+ */
+int AStarParser::getPoppedCount() const{
+    return poppedCount;
+}
+
+/**
+ * Constructs the most probable parse tree for a given sentence according to the given grammar.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param sentence Sentence to be parsed.
+ * @return Array list containing the most probable parse tree for the given sentence, empty if the sentence can not
+ * be parsed.
+ */
+vector<ParseTree*> AStarParser::parse(const ProbabilisticContextFreeGrammar& pCfg, const Sentence* sentence){
+    vector<string> words;
+    for (int i = 0; i < sentence->wordCount(); i++){
+        words.emplace_back(sentence->getWord(i)->getName());
+    }
+    return parse(pCfg, words);
+}
+
+/**
+ * Constructs the most probable parse tree for the given words best first. Edges, the derivations of the non-terminals
+ * over the spans, are popped from a binary heap in the order of their log probability plus the outside estimate of
+ * their non-terminal. As the estimate never underestimates the best context of a non-terminal, and the rules only
+ * decrease log probabilities, every edge is popped with its best derivation, and parsing stops as soon as the start
+ * symbol over the whole sentence is popped, with the same log probability as the Viterbi parse. Only the popped edges
+ * are combined; the spans and non-terminals which can not beat the best parse are never built. The grammar must be in
+ * Chomsky normal form; unary rules are applied with the unary closure of the grammar, but a grammar with rules of more
+ * than two symbols on the right hand side is rejected, since the edges only combine two children. The words are only
+ * read, and they are the leaves of the parse tree.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param words Words of the sentence to be parsed.
+ * @return Array list containing the most probable parse tree for the given words, empty if the words can not be
+ * parsed.
+ * @throws invalid_argument if the grammar has rules with more than two symbols on the right hand side.
+ */
+vector<ParseTree*> AStarParser::parse(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words){
+    int i, r, root = -1, wordCount = words.size(), startSymbolId = pCfg.getStartSymbolId();
+    pair<int, int> range;
+    vector<ParseTree*> parseTrees;
+    if (pCfg.hasMultipleNonTerminalRules()){
+        throw invalid_argument("AStarParser needs a grammar in Chomsky normal form without rules of more than two symbols on the right hand side");
+    }
+    poppedCount = 0;
+    if (wordCount == 0 || startSymbolId == -1 || startSymbolId >= pCfg.getNonTerminalCount()){
+        return parseTrees;
+    }
+    pCfg.normalizeWords(words, wordSymbolIds);
+    edges.clear();
+    edgeIndexes.clear();
+    agenda = priority_queue<pair<double, int>>();
+    startingAt.resize(wordCount);
+    endingAt.resize(wordCount);
+    for (i = 0; i < wordCount; i++){
+        startingAt[i].clear();
+        endingAt[i].clear();
+    }
+    for (i = 0; i < wordCount; i++){
+        range = pCfg.getTerminalRuleRange(wordSymbolIds[i]);
+        for (r = range.first; r < range.second; r++){
+            Rule* rule = pCfg.getTerminalRule(r);
+            offer(pCfg, wordCount, {i, i, rule->getLeftHandSideId(), ((ProbabilisticRule*) rule)->getLogProbability(), -1, -1, r, false});
+        }
+    }
+    while (!agenda.empty()){
+        int index = agenda.top().second;
+        agenda.pop();
+        if (edges[index].finished){
+            continue;
+        }
+        edges[index].finished = true;
+        poppedCount++;
+        if (edges[index].start == 0 && edges[index].end == wordCount - 1 && edges[index].symbolId == startSymbolId){
+            root = index;
+            break;
+        }
+        combine(pCfg, wordCount, index);
+    }
+    if (root != -1){
+        auto* parseTree = new ParseTree(constructTree(pCfg, words, root));
+        parseTree->correctParents();
+        parseTree->removeXNodes();
+        parseTrees.emplace_back(parseTree);
+    }
+    return parseTrees;
+}
@@ -0,0 +1,50 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#ifndef SYNTACTICPARSER_ASTARPARSER_H
+#define SYNTACTICPARSER_ASTARPARSER_H
+
+
+#include <queue>
+#include <span>
+#include <unordered_map>
+#include "ProbabilisticParser.h"
+
+/**
+ * Derivation of a non-terminal over the span (start, end) in the A* parser. A binary edge points to the edges of its
+ * two children and stores the position of its rule in the binary rule index. For a terminal edge, right is -1 and rule
+ * is the position of the terminal rule; for a chain of unary rules, right is -2, left is the edge at the bottom of the
+ * chain and rule is the unary closure entry of the chain.
+ */
+struct AStarEdge {
+    int start;
+    int end;
+    int symbolId;
+    double logProbability;
+    int left;
+    int right;
+    int rule;
+    bool finished;
+};
+
+class AStarParser : public ProbabilisticParser{
+private:
+    vector<int> wordSymbolIds;
+    vector<AStarEdge> edges;
+    unordered_map<long long, int> edgeIndexes;
+    priority_queue<pair<double, int>> agenda;
+    vector<vector<int>> startingAt;
+    vector<vector<int>> endingAt;
+    int poppedCount = 0;
+    void offer(const ProbabilisticContextFreeGrammar& pCfg, int wordCount, const AStarEdge& edge);
+    void combine(const ProbabilisticContextFreeGrammar& pCfg, int wordCount, int index);
+    ParseNode* constructTree(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words, int index) const;
+public:
+    [[nodiscard]] int getPoppedCount() const;
+    vector<ParseTree*> parse(const ProbabilisticContextFreeGrammar& pCfg, const Sentence* sentence);
+    vector<ParseTree*> parse(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words);
+};
+
+
+#endif //SYNTACTICPARSER_ASTARPARSER_H
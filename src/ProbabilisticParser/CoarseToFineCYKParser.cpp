@@ -0,0 +1,164 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include <limits>
+#include "CoarseToFineCYKParser.h"
+
+/**
+ * Constructor for the coarse-to-fine parser. The coarse grammar is projected from the fine grammar onto the label
+ * families of its non-terminals.
+ * @param fineGrammar Grammar the sentences will be parsed with.
+ * @param maskThreshold Maximum distance in log probability between the best coarse parse and the best coarse parse
+ *                      through an item, for the fine items of the same class to be built.
+ */
+CoarseToFineCYKParser::CoarseToFineCYKParser(const ProbabilisticContextFreeGrammar& fineGrammar, double maskThreshold) :
+        CoarseToFineCYKParser(fineGrammar, fineGrammar.labelFamilyProjection(), maskThreshold){
+}
+
+/**
+ * Constructor for the coarse-to-fine parser with a given projection of the non-terminals of the fine grammar.
+ * @param fineGrammar Grammar the sentences will be parsed with.
+ * @param projection Class name of every non-terminal of the fine grammar, indexed by the non-terminal ids.
+ * @param maskThreshold Maximum distance in log probability between the best coarse parse and the best coarse parse
+ *                      through an item, for the fine items of the same class to be built.
+ */
+CoarseToFineCYKParser::CoarseToFineCYKParser(const ProbabilisticContextFreeGrammar& fineGrammar, const vector<string>& projection, double maskThreshold) :
+        coarseGrammar(fineGrammar, projection){
+    this->maskThreshold = maskThreshold;
+    for (const string& name : projection){
+        fineToCoarse.emplace_back(coarseGrammar.getSymbolId(name));
+    }
+}
+
+/**
+ * Accessor for the coarse grammar.
+ * @return Coarse grammar projected from the fine grammar.
+ */
+const ProbabilisticContextFreeGrammar& CoarseToFineCYKParser::getCoarseGrammar() const{
+    return coarseGrammar;
+}
+
+/**
+ * Parses the sentence with the coarse grammar and marks the coarse items which can be part of a good parse. The
+ * Viterbi inside scores come from the coarse chart; the Viterbi outside scores are computed top down, pushing the
+ * outside score of every item of a cell first down the chains of the unary closure within the cell, and then to the
+ * two children of every rule. An item survives if its inside plus outside score, the score of the best coarse parse
+ * through it, is within the threshold of the best coarse parse. The coarse grammar shares the dictionary of the fine
+ * grammar, so the coarse parser normalizes the words into its own buffer exactly as the fine parser does.
+ * @param words Words of the sentence to be parsed.
+ */
+void CoarseToFineCYKParser::computeMask(span<const string> words){
+    int i, j, k, r, wordCount = words.size(), coarseCount = coarseGrammar.getNonTerminalCount(), startSymbolId = coarseGrammar.getStartSymbolId();
+    masked = false;
+    if (wordCount == 0 || startSymbolId == -1 || startSymbolId >= coarseCount){
+        return;
+    }
+    coarseParser.fillChart(coarseGrammar, words);
+    const ViterbiChart& chart = coarseParser.getChart();
+    double best = chart.getScore(0, wordCount - 1, startSymbolId);
+    if (best == -numeric_limits<double>::infinity()){
+        return;
+    }
+    int cellCount = wordCount * (wordCount + 1) / 2;
+    outsideScores.assign((size_t) cellCount * coarseCount, -numeric_limits<double>::infinity());
+    mask.assign((size_t) cellCount * coarseCount, 0);
+    outsideScores[(size_t) chart.cellIndex(0, wordCount - 1) * coarseCount + startSymbolId] = 0.0;
+    auto applyUnaryClosure = [&](int start, int end){
+        double* cellOutside = outsideScores.data() + (size_t) chart.cellIndex(start, end) * coarseCount;
+        for (int symbolId : chart.getActiveSymbols(start, end)){
+            pair<int, int> range = coarseGrammar.getUnaryClosureRange(symbolId);
+            for (int e = range.first; e < range.second; e++){
+                const UnaryClosureEntry& entry = coarseGrammar.getUnaryClosureEntry(e);
+                cellOutside[symbolId] = max(cellOutside[symbolId], cellOutside[entry.symbolId] + entry.logProbability);
+            }
+        }
+    };
+    for (int length = wordCount - 1; length >= 1; length--){
+        for (i = 0; i + length < wordCount; i++){
+            j = i + length;
+            applyUnaryClosure(i, j);
+            const double* parentOutside = outsideScores.data() + (size_t) chart.cellIndex(i, j) * coarseCount;
+            for (k = i; k < j; k++){
+                const double* rightScores = chart.getScores(k + 1, j);
+                double* leftOutside = outsideScores.data() + (size_t) chart.cellIndex(i, k) * coarseCount;
+                double* rightOutside = outsideScores.data() + (size_t) chart.cellIndex(k + 1, j) * coarseCount;
+                for (int leftSymbol : chart.getActiveSymbols(i, k)){
+                    double leftScore = chart.getScore(i, k, leftSymbol);
+                    BinaryRuleBlock block = coarseGrammar.getBinaryRulesWithLeftChild(leftSymbol);
+                    for (r = 0; r < block.size; r++){
+                        double outside = parentOutside[block.parents[r]] + block.logProbabilities[r];
+                        double rightScore = rightScores[block.rightChildren[r]];
+                        if (outside == -numeric_limits<double>::infinity() || rightScore == -numeric_limits<double>::infinity()){
+                            continue;
+                        }
+                        leftOutside[leftSymbol] = max(leftOutside[leftSymbol], outside + rightScore);
+                        rightOutside[block.rightChildren[r]] = max(rightOutside[block.rightChildren[r]], outside + leftScore);
+                    }
+                }
+            }
+        }
+    }
+    for (i = 0; i < wordCount; i++){
+        applyUnaryClosure(i, i);
+    }
+    for (i = 0; i < wordCount; i++){
+        for (j = i; j < wordCount; j++){
+            size_t cell = (size_t) chart.cellIndex(i, j) * coarseCount;
+            for (int symbolId : chart.getActiveSymbols(i, j)){
+                if (chart.getScore(i, j, symbolId) + outsideScores[cell + symbolId] >= best - maskThreshold){
+                    mask[cell + symbolId] = 1;
+                }
+            }
+        }
+    }
+    masked = true;
+}
+
+/**
+ * Allows a fine item only if the coarse item of its class survived the coarse pass.
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @param symbolId Id of the non-terminal symbol in the fine grammar.
+ * @return True, if the item may be built; false otherwise.
+ */
+bool CoarseToFineCYKParser::allowed(int i, int j, int symbolId) const{
+    if (!masked){
+        return true;
+    }
+    return mask[(size_t) coarseParser.getChart().cellIndex(i, j) * coarseGrammar.getNonTerminalCount() + fineToCoarse[symbolId]];
+}
+
+/**
+ * Constructs the most probable parse trees for a given sentence in two passes. The sentence is first parsed with the
+ * coarse grammar, and then with the fine grammar by ProbabilisticCYKParser, which only builds the items whose coarse
+ * class survived the coarse pass. If the restricted fine pass finds no parse, the sentence is parsed again without
+ * restriction. The words of the sentence are not changed.
+ * @param pCfg Fine grammar the coarse grammar was projected from.
+ * @param sentence Sentence to be parsed.
+ * @return Array list of most probable parse trees for the given sentence.
+ */
+vector<ParseTree*> CoarseToFineCYKParser::parse(const ProbabilisticContextFreeGrammar& pCfg, const Sentence* sentence){
+    vector<string> words;
+    for (int i = 0; i < sentence->wordCount(); i++){
+        words.emplace_back(sentence->getWord(i)->getName());
+    }
+    return parse(pCfg, words);
+}
+
+/**
+ * Constructs the most probable parse trees for the given words in two passes, as the sentence overload does. Both
+ * passes only read the words and normalize them into the buffers of their parsers.
+ * @param pCfg Fine grammar the coarse grammar was projected from.
+ * @param words Words of the sentence to be parsed.
+ * @return Array list of most probable parse trees for the given words.
+ */
+vector<ParseTree*> CoarseToFineCYKParser::parse(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words){
+    computeMask(words);
+    vector<ParseTree*> parseTrees = ProbabilisticCYKParser::parse(pCfg, words);
+    if (parseTrees.empty() && masked){
+        masked = false;
+        parseTrees = ProbabilisticCYKParser::parse(pCfg, words);
+    }
+    return parseTrees;
+}
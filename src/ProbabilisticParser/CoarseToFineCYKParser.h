@@ -0,0 +1,33 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#ifndef SYNTACTICPARSER_COARSETOFINECYKPARSER_H
+#define SYNTACTICPARSER_COARSETOFINECYKPARSER_H
+
+
+#include "ProbabilisticCYKParser.h"
+#include "ViterbiCYKParser.h"
+
+class CoarseToFineCYKParser : public ProbabilisticCYKParser{
+private:
+    ProbabilisticContextFreeGrammar coarseGrammar;
+    vector<int> fineToCoarse;
+    double maskThreshold;
+    ViterbiCYKParser coarseParser;
+    vector<double> outsideScores;
+    vector<char> mask;
+    bool masked = false;
+    void computeMask(span<const string> words);
+protected:
+    [[nodiscard]] bool allowed(int i, int j, int symbolId) const override;
+public:
+    CoarseToFineCYKParser(const ProbabilisticContextFreeGrammar& fineGrammar, double maskThreshold);
+    CoarseToFineCYKParser(const ProbabilisticContextFreeGrammar& fineGrammar, const vector<string>& projection, double maskThreshold);
+    [[nodiscard]] const ProbabilisticContextFreeGrammar& getCoarseGrammar() const;
+    vector<ParseTree*> parse(const ProbabilisticContextFreeGrammar& pCfg, const Sentence* sentence) override;
+    vector<ParseTree*> parse(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words);
+};
+
+
+#endif //SYNTACTICPARSER_COARSETOFINECYKPARSER_H
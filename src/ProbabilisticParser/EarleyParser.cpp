@@ -0,0 +1,269 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include <algorithm>
+#include <limits>
+#include "EarleyParser.h"
+#include "../ProbabilisticContextFreeGrammar/ProbabilisticParseNode.h"
+
+/**
+ * Adds an item ending at the current column to the chart. If the same dotted rule over the same start was already
+ * added to the column, only the more probable of the two derivations is kept.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param wordCount Number of words in the sentence.
+ * @param rule Position of the rule in the left corner index of the grammar.
+ * @param dot Number of symbols of the rule recognized so far.
+ * @param start Start position of the item.
+ * @param logProbability Log probability of the rule and the recognized symbols.
+ * @param previous Item before the last recognized symbol, -1 if it is the first symbol.
+ * @param child Constituent of the last recognized symbol.
+ */
+void EarleyParser::addItem(const ProbabilisticContextFreeGrammar& pCfg, int wordCount, int rule, int dot, int start, double logProbability, int previous, int child){
+    long long key = ((long long) rule << 32) | (unsigned int) (dot * (wordCount + 1) + start);
+    auto [position, inserted] = columnItems.emplace(key, items.size());
+    if (inserted){
+        items.push_back({rule, dot, start, pCfg.getLeftCornerRule(rule)->getRightHandSideIdAt(dot), logProbability, previous, child});
+    } else {
+        EarleyItem& item = items[position->second];
+        if (logProbability > item.logProbability){
+            item.logProbability = logProbability;
+            item.previous = previous;
+            item.child = child;
+        }
+    }
+}
+
+/**
+ * Offers a derivation of a non-terminal over the current span, which replaces the best derivation of the non-terminal
+ * found so far if it is more probable.
+ * @param constituent Derivation of the non-terminal.
+ */
+void EarleyParser::addConstituent(const EarleyConstituent& constituent){
+    if (constituent.logProbability > cellScores[constituent.symbolId]){
+        if (cellScores[constituent.symbolId] == -numeric_limits<double>::infinity()){
+            cellSymbols.emplace_back(constituent.symbolId);
+        }
+        cellScores[constituent.symbolId] = constituent.logProbability;
+        cellBest[constituent.symbolId] = constituent;
+        cellIndexes[constituent.symbolId] = -1;
+    }
+}
+
+/**
+ * Marks the non-terminal and its left corner closure as predicted at the given column, so that the rules of those
+ * non-terminals may start there. A non-terminal already marked is skipped, since the left corner closure is
+ * transitive and its closure is already marked.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param column Position where the non-terminal is expected.
+ * @param symbolId Id of the expected symbol.
+ */
+void EarleyParser::predict(const ProbabilisticContextFreeGrammar& pCfg, int column, int symbolId){
+    int nonTerminalCount = pCfg.getNonTerminalCount();
+    if (symbolId >= nonTerminalCount || predicted[(size_t) column * nonTerminalCount + symbolId]){
+        return;
+    }
+    predicted[(size_t) column * nonTerminalCount + symbolId] = 1;
+    for (int leftCorner : pCfg.getLeftCornerClosure(symbolId)){
+        predicted[(size_t) column * nonTerminalCount + leftCorner] = 1;
+    }
+}
+
+/**
+ * Finds the best derivations of all non-terminals over the spans ending at column j, from the shortest span to the
+ * longest. As the grammar has no empty rules, every rule with two or more symbols completing a span (i, j) is
+ * advanced over a shorter span (k, j), k > i, so the completions of (i, j) are all known when the span is reached.
+ * The unary rules are not items of the chart; they are applied to every span with the unary closure of the grammar.
+ * Every best derivation of a span (i, j) then advances the items of column i expecting its non-terminal, and starts
+ * the rules having it as their first symbol whose left hand side is predicted at i.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param j Column of the chart, the end position of the spans.
+ * @param wordCount Number of words in the sentence.
+ * @return Index of the best derivation of the start symbol over the span (0, j), -1 if there is none.
+ */
+int EarleyParser::completeColumn(const ProbabilisticContextFreeGrammar& pCfg, int j, int wordCount){
+    int i, r, t, root = -1, startSymbolId = pCfg.getStartSymbolId(), nonTerminalCount = pCfg.getNonTerminalCount();
+    pair<int, int> range;
+    columnItems.clear();
+    for (i = j - 1; i >= 0; i--){
+        if (i == j - 1){
+            range = pCfg.getTerminalRuleRange(wordSymbolIds[i]);
+            for (r = range.first; r < range.second; r++){
+                Rule* candidate = pCfg.getTerminalRule(r);
+                addConstituent({candidate->getLeftHandSideId(), ((ProbabilisticRule*) candidate)->getLogProbability(), -1, i, r});
+            }
+        }
+        for (const EarleyConstituent& constituent : completed[i]){
+            addConstituent(constituent);
+        }
+        completed[i].clear();
+        unaryBase.clear();
+        for (int symbolId : cellSymbols){
+            cellIndexes[symbolId] = constituents.size();
+            unaryBase.emplace_back(constituents.size());
+            constituents.emplace_back(cellBest[symbolId]);
+        }
+        if (pCfg.hasUnaryRules()){
+            for (int base : unaryBase){
+                range = pCfg.getUnaryClosureRange(constituents[base].symbolId);
+                for (r = range.first; r < range.second; r++){
+                    const UnaryClosureEntry& entry = pCfg.getUnaryClosureEntry(r);
+                    addConstituent({entry.symbolId, constituents[base].logProbability + entry.logProbability, -2, base, r});
+                }
+            }
+            for (int symbolId : cellSymbols){
+                if (cellIndexes[symbolId] == -1){
+                    cellIndexes[symbolId] = constituents.size();
+                    constituents.emplace_back(cellBest[symbolId]);
+                }
+            }
+        }
+        for (int symbolId : cellSymbols){
+            int index = cellIndexes[symbolId];
+            double score = cellScores[symbolId];
+            t = lower_bound(items.begin() + columnOffsets[i], items.begin() + columnOffsets[i + 1], symbolId, [](const EarleyItem& item, int symbolId){
+                return item.nextSymbol < symbolId;
+            }) - items.begin();
+            for (; t < columnOffsets[i + 1] && items[t].nextSymbol == symbolId; t++){
+                EarleyItem item = items[t];
+                Rule* rule = pCfg.getLeftCornerRule(item.rule);
+                if (item.dot + 1 == rule->getRightHandSideSize()){
+                    completed[item.start].push_back({rule->getLeftHandSideId(), item.logProbability + score, t, index, item.rule});
+                } else {
+                    addItem(pCfg, wordCount, item.rule, item.dot + 1, item.start, item.logProbability + score, t, index);
+                }
+            }
+            range = pCfg.getLeftCornerRuleRange(symbolId);
+            for (r = range.first; r < range.second; r++){
+                Rule* rule = pCfg.getLeftCornerRule(r);
+                if (predicted[(size_t) i * nonTerminalCount + rule->getLeftHandSideId()]){
+                    addItem(pCfg, wordCount, r, 1, i, ((ProbabilisticRule*) rule)->getLogProbability() + score, -1, index);
+                }
+            }
+        }
+        if (i == 0 && cellScores[startSymbolId] > -numeric_limits<double>::infinity()){
+            root = cellIndexes[startSymbolId];
+        }
+        for (int symbolId : cellSymbols){
+            cellScores[symbolId] = -numeric_limits<double>::infinity();
+            cellIndexes[symbolId] = -1;
+        }
+        cellSymbols.clear();
+    }
+    return root;
+}
+
+/**
+ * Closes column j after all its items are added: the items are grouped by the symbol they expect next, so that the
+ * spans starting at j find their items with a binary search, and the expected non-terminals are predicted at j.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param j Column of the chart.
+ * @param wordCount Number of words in the sentence.
+ */
+void EarleyParser::finishColumn(const ProbabilisticContextFreeGrammar& pCfg, int j, int wordCount){
+    stable_sort(items.begin() + columnOffsets[j], items.end(), [](const EarleyItem& itemA, const EarleyItem& itemB){
+        return itemA.nextSymbol < itemB.nextSymbol;
+    });
+    columnOffsets.emplace_back(items.size());
+    if (j < wordCount){
+        for (int t = columnOffsets[j]; t < columnOffsets[j + 1]; t++){
+            if (t == columnOffsets[j] || items[t].nextSymbol != items[t - 1].nextSymbol){
+                predict(pCfg, j, items[t].nextSymbol);
+            }
+        }
+    }
+}
+
+/**
+ * Constructs the subtree of the best derivation with the given index by following the items and the constituents of
+ * its children.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param words Words of the sentence, the leaves of the tree.
+ * @param index Index of the constituent at the root of the subtree.
+ * @return Root of the subtree of the best derivation.
+ */
+ParseNode* EarleyParser::constructTree(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words, int index) const{
+    const EarleyConstituent& constituent = constituents[index];
+    if (constituent.item == -1){
+        return new ProbabilisticParseNode(new ParseNode(Symbol(words[constituent.child])), pCfg.getSymbol(constituent.symbolId), constituent.logProbability);
+    }
+    if (constituent.item == -2){
+        vector<int> chain;
+        for (int entry = constituent.rule; entry != -1; entry = pCfg.getUnaryClosureEntry(entry).below){
+            chain.emplace_back(entry);
+        }
+        ParseNode* node = constructTree(pCfg, words, constituent.child);
+        for (int k = chain.size() - 1; k >= 0; k--){
+            const UnaryClosureEntry& entry = pCfg.getUnaryClosureEntry(chain[k]);
+            node = new ProbabilisticParseNode(node, pCfg.getSymbol(entry.symbolId), constituents[constituent.child].logProbability + entry.logProbability);
+        }
+        return node;
+    }
+    vector<int> children;
+    children.emplace_back(constituent.child);
+    for (int item = constituent.item; item != -1; item = items[item].previous){
+        children.emplace_back(items[item].child);
+    }
+    auto* node = new ProbabilisticParseNode(pCfg.getSymbol(constituent.symbolId), constituent.logProbability);
+    for (int k = children.size() - 1; k >= 0; k--){
+        node->addChild(constructTree(pCfg, words, children[k]));
+    }
+    return node;
+}
+
+/**
+ * Constructs the most probable parse tree for a given sentence according to the given grammar.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param sentence Sentence to be parsed.
+ * @return Array list containing the most probable parse tree for the given sentence, empty if the sentence can not
+ * be parsed.
+ */
+vector<ParseTree*> EarleyParser::parse(const ProbabilisticContextFreeGrammar& pCfg, const Sentence* sentence){
+    vector<string> words;
+    for (int i = 0; i < sentence->wordCount(); i++){
+        words.emplace_back(sentence->getWord(i)->getName());
+    }
+    return parse(pCfg, words);
+}
+
+/**
+ * Constructs the most probable parse tree for the given words with an Earley chart, which works directly on the rules
+ * as induced from a treebank, without converting the grammar into Chomsky normal form. Only the dotted rules reached
+ * from the start symbol are stored, each once per start position with its best derivation, and the best derivation
+ * of every non-terminal over a span is kept only while its span is processed; there is no cell for every span and
+ * non-terminal as in the CYK parsers. Rules such as X -> a must be the only rules with terminal symbols, and the
+ * grammar must not contain empty rules. The words are only read: rare words and numbers are converted to the ids of
+ * _rare_ and _num_ in a separate buffer, and the words themselves are the leaves of the parse tree.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param words Words of the sentence to be parsed.
+ * @return Array list containing the most probable parse tree for the given words, empty if the words can not be
+ * parsed.
+ */
+vector<ParseTree*> EarleyParser::parse(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words){
+    int j, root = -1, wordCount = words.size(), nonTerminalCount = pCfg.getNonTerminalCount(), startSymbolId = pCfg.getStartSymbolId();
+    vector<ParseTree*> parseTrees;
+    if (wordCount == 0 || startSymbolId == -1 || startSymbolId >= nonTerminalCount){
+        return parseTrees;
+    }
+    pCfg.normalizeWords(words, wordSymbolIds);
+    items.clear();
+    constituents.clear();
+    columnOffsets.assign(2, 0);
+    completed.resize(wordCount);
+    predicted.assign((size_t) wordCount * nonTerminalCount, 0);
+    cellScores.assign(nonTerminalCount, -numeric_limits<double>::infinity());
+    cellIndexes.assign(nonTerminalCount, -1);
+    cellBest.resize(nonTerminalCount);
+    predict(pCfg, 0, startSymbolId);
+    for (j = 1; j <= wordCount; j++){
+        root = completeColumn(pCfg, j, wordCount);
+        finishColumn(pCfg, j, wordCount);
+    }
+    if (root != -1){
+        auto* parseTree = new ParseTree(constructTree(pCfg, words, root));
+        parseTree->correctParents();
+        parseTree->removeXNodes();
+        parseTrees.emplace_back(parseTree);
+    }
+    return parseTrees;
+}
@@ -0,0 +1,68 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#ifndef SYNTACTICPARSER_EARLEYPARSER_H
+#define SYNTACTICPARSER_EARLEYPARSER_H
+
+
+#include <span>
+#include <unordered_map>
+#include "ProbabilisticParser.h"
+
+/**
+ * Dotted rule X -> Y1 ... Yd . Yd+1 ... of the Earley chart, spanning the words from start up to the column of the
+ * item. The rule is given by its position in the left corner index of the grammar; previous is the item before the
+ * last symbol Yd was recognized, -1 if Yd is the first symbol, and child is the constituent of Yd.
+ */
+struct EarleyItem {
+    int rule;
+    int dot;
+    int start;
+    int nextSymbol;
+    double logProbability;
+    int previous;
+    int child;
+};
+
+/**
+ * Best derivation of a non-terminal over a span. item is the last item of the rule before its last symbol child was
+ * recognized; -1 for a terminal rule, where child is the position of the word and rule the position of the terminal
+ * rule; -2 for a chain of unary rules, where child is the constituent at the bottom of the chain and rule the unary
+ * closure entry of the chain.
+ */
+struct EarleyConstituent {
+    int symbolId;
+    double logProbability;
+    int item;
+    int child;
+    int rule;
+};
+
+class EarleyParser : public ProbabilisticParser{
+private:
+    vector<int> wordSymbolIds;
+    vector<EarleyItem> items;
+    vector<int> columnOffsets;
+    vector<EarleyConstituent> constituents;
+    vector<vector<EarleyConstituent>> completed;
+    vector<char> predicted;
+    unordered_map<long long, int> columnItems;
+    vector<double> cellScores;
+    vector<int> cellIndexes;
+    vector<EarleyConstituent> cellBest;
+    vector<int> cellSymbols;
+    vector<int> unaryBase;
+    void addItem(const ProbabilisticContextFreeGrammar& pCfg, int wordCount, int rule, int dot, int start, double logProbability, int previous, int child);
+    void addConstituent(const EarleyConstituent& constituent);
+    void predict(const ProbabilisticContextFreeGrammar& pCfg, int column, int symbolId);
+    int completeColumn(const ProbabilisticContextFreeGrammar& pCfg, int j, int wordCount);
+    void finishColumn(const ProbabilisticContextFreeGrammar& pCfg, int j, int wordCount);
+    ParseNode* constructTree(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words, int index) const;
+public:
+    vector<ParseTree*> parse(const ProbabilisticContextFreeGrammar& pCfg, const Sentence* sentence);
+    vector<ParseTree*> parse(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words);
+};
+
+
+#endif //SYNTACTICPARSER_EARLEYPARSER_H
@@ -0,0 +1,247 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include <algorithm>
+#include <stdexcept>
+#include "KBestCYKParser.h"
+#include "../ProbabilisticContextFreeGrammar/ProbabilisticParseNode.h"
+
+/**
+ * Compares two derivations with respect to their log probabilities, so that the heap of candidates keeps the most
+ * probable derivation on top.
+ */
+static bool compareDerivation(const KBestDerivation& derivationA, const KBestDerivation& derivationB){
+    return derivationA.score < derivationB.score;
+}
+
+/**
+ * Constructor for the k-best parser.
+ * @param k Maximum number of parse trees returned for a sentence.
+ */
+KBestCYKParser::KBestCYKParser(int k) {
+    this->k = k;
+}
+
+/**
+ * Returns the vertex of the given symbol over the span (i, j), creating it if it is visited for the first time.
+ * Vertices are created only for the part of the chart the k best derivations actually visit.
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @param symbolId Id of the non-terminal symbol.
+ * @return Index of the vertex.
+ */
+int KBestCYKParser::getVertex(int i, int j, int symbolId) {
+    long long key = (long long) chart.cellIndex(i, j) * (1LL << 32) + symbolId;
+    auto found = vertexIndex.find(key);
+    if (found != vertexIndex.end()){
+        return found->second;
+    }
+    KBestVertex vertex;
+    vertex.start = i;
+    vertex.end = j;
+    vertex.symbolId = symbolId;
+    vertices.emplace_back(vertex);
+    vertexIndex.emplace(key, vertices.size() - 1);
+    return vertices.size() - 1;
+}
+
+/**
+ * Returns the log probability of the derivation with the given rank of a vertex. The best derivation of every
+ * vertex is already in the Viterbi chart, so the derivations with rank 0 are never computed only to be scored.
+ * @param vertex Index of the vertex.
+ * @param rank Rank of the derivation.
+ * @return Log probability of the derivation.
+ */
+double KBestCYKParser::getScore(int vertex, int rank) const {
+    if (rank == 0){
+        return chart.getScore(vertices[vertex].start, vertices[vertex].end, vertices[vertex].symbolId);
+    }
+    return vertices[vertex].derivations[rank].score;
+}
+
+/**
+ * Adds the derivation, which combines the derivations with the given ranks of the children of the given hyperedge,
+ * to the candidates of the vertex, unless it has been added before.
+ * @param vertex Index of the vertex.
+ * @param edge Index of the hyperedge in the incoming hyperedges of the vertex.
+ * @param leftRank Rank of the derivation of the left child.
+ * @param rightRank Rank of the derivation of the right child.
+ */
+void KBestCYKParser::pushCandidate(int vertex, int edge, int leftRank, int rightRank) {
+    long long key = ((long long) edge * (k + 1) + leftRank) * (k + 1) + rightRank;
+    if (!vertices[vertex].seen.insert(key).second){
+        return;
+    }
+    const KBestHyperedge& hyperedge = vertices[vertex].edges[edge];
+    double score = hyperedge.score;
+    if (hyperedge.split != -1){
+        score += getScore(hyperedge.leftVertex, leftRank) + getScore(hyperedge.rightVertex, rightRank);
+    }
+    vertices[vertex].candidates.push_back({edge, leftRank, rightRank, score});
+    push_heap(vertices[vertex].candidates.begin(), vertices[vertex].candidates.end(), compareDerivation);
+}
+
+/**
+ * Creates the incoming hyperedges of a vertex when it is visited for the first time: a terminal rule for a span of
+ * one word, otherwise every rule and split point combining two non-terminals of the chart. The best derivation of
+ * every hyperedge becomes a candidate of the vertex.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param vertex Index of the vertex.
+ */
+void KBestCYKParser::expandVertex(const ProbabilisticContextFreeGrammar& pCfg, int vertex) {
+    int i = vertices[vertex].start, j = vertices[vertex].end, symbolId = vertices[vertex].symbolId, split, r;
+    pair<int, int> range;
+    vector<KBestHyperedge> edges;
+    if (i == j){
+        range = pCfg.getTerminalRuleRange(wordSymbolIds[i]);
+        for (r = range.first; r < range.second; r++){
+            auto* candidate = (ProbabilisticRule*) pCfg.getTerminalRule(r);
+            if (candidate->getLeftHandSideId() == symbolId){
+                edges.push_back({-1, r, -1, -1, candidate->getLogProbability()});
+            }
+        }
+    } else {
+        for (split = i; split < j; split++){
+            for (int leftSymbol : chart.getActiveSymbols(i, split)){
+                for (int rightSymbol : chart.getActiveSymbols(split + 1, j)){
+                    range = pCfg.getBinaryRuleRange(leftSymbol, rightSymbol);
+                    for (r = range.first; r < range.second; r++){
+                        auto* candidate = (ProbabilisticRule*) pCfg.getBinaryRule(r);
+                        if (candidate->getLeftHandSideId() == symbolId){
+                            int leftVertex = getVertex(i, split, leftSymbol);
+                            int rightVertex = getVertex(split + 1, j, rightSymbol);
+                            edges.push_back({split, r, leftVertex, rightVertex, candidate->getLogProbability()});
+                        }
+                    }
+                }
+            }
+        }
+    }
+    vertices[vertex].edges = edges;
+    vertices[vertex].expanded = true;
+    for (int edge = 0; edge < edges.size(); edge++){
+        pushCandidate(vertex, edge, 0, 0);
+    }
+}
+
+/**
+ * Adds the successors of a derivation to the candidates of a vertex. A successor uses the next best derivation of
+ * one of the children, which is itself computed lazily.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param vertex Index of the vertex.
+ * @param derivation Derivation of the vertex whose successors will be added.
+ */
+void KBestCYKParser::lazyNext(const ProbabilisticContextFreeGrammar& pCfg, int vertex, const KBestDerivation& derivation) {
+    KBestHyperedge hyperedge = vertices[vertex].edges[derivation.edge];
+    if (hyperedge.split == -1){
+        return;
+    }
+    if (derivation.leftRank + 1 < k && lazyKthBest(pCfg, hyperedge.leftVertex, derivation.leftRank + 1)){
+        pushCandidate(vertex, derivation.edge, derivation.leftRank + 1, derivation.rightRank);
+    }
+    if (derivation.rightRank + 1 < k && lazyKthBest(pCfg, hyperedge.rightVertex, derivation.rightRank + 1)){
+        pushCandidate(vertex, derivation.edge, derivation.leftRank, derivation.rightRank + 1);
+    }
+}
+
+/**
+ * Computes the derivations of a vertex in decreasing order of probability until the derivation with the given rank
+ * is found (Huang and Chiang, 2005, Algorithm 3).
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param vertex Index of the vertex.
+ * @param rank Rank of the derivation.
+ * @return True, if the vertex has at least rank + 1 derivations; false otherwise.
+ */
+bool KBestCYKParser::lazyKthBest(const ProbabilisticContextFreeGrammar& pCfg, int vertex, int rank) {
+    if (!vertices[vertex].expanded){
+        expandVertex(pCfg, vertex);
+    }
+    while (vertices[vertex].derivations.size() <= rank){
+        if (!vertices[vertex].derivations.empty()){
+            KBestDerivation last = vertices[vertex].derivations.back();
+            lazyNext(pCfg, vertex, last);
+        }
+        vector<KBestDerivation>& candidates = vertices[vertex].candidates;
+        if (candidates.empty()){
+            return false;
+        }
+        pop_heap(candidates.begin(), candidates.end(), compareDerivation);
+        KBestDerivation best = candidates.back();
+        candidates.pop_back();
+        vertices[vertex].derivations.emplace_back(best);
+    }
+    return true;
+}
+
+/**
+ * Constructs the subtree of the derivation with the given rank of a vertex.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param words Words of the sentence, the leaves of the trees.
+ * @param vertex Index of the vertex.
+ * @param rank Rank of the derivation.
+ * @return Root of the subtree of the derivation.
+ */
+ParseNode* KBestCYKParser::constructTree(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words, int vertex, int rank) {
+    lazyKthBest(pCfg, vertex, rank);
+    KBestDerivation derivation = vertices[vertex].derivations[rank];
+    KBestHyperedge hyperedge = vertices[vertex].edges[derivation.edge];
+    const Symbol& symbol = pCfg.getSymbol(vertices[vertex].symbolId);
+    if (hyperedge.split == -1){
+        return new ProbabilisticParseNode(new ParseNode(Symbol(words[vertices[vertex].start])), symbol, derivation.score);
+    }
+    ParseNode* left = constructTree(pCfg, words, hyperedge.leftVertex, derivation.leftRank);
+    ParseNode* right = constructTree(pCfg, words, hyperedge.rightVertex, derivation.rightRank);
+    return new ProbabilisticParseNode(left, right, symbol, derivation.score);
+}
+
+/**
+ * Constructs the k most probable parse trees for a given sentence according to the given grammar. The words of the
+ * sentence are not changed.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param sentence Sentence to be parsed.
+ * @return Array list of at most k parse trees in decreasing order of probability.
+ */
+vector<ParseTree*> KBestCYKParser::parse(const ProbabilisticContextFreeGrammar& pCfg, const Sentence* sentence){
+    vector<string> words;
+    for (int i = 0; i < sentence->wordCount(); i++){
+        words.emplace_back(sentence->getWord(i)->getName());
+    }
+    return parse(pCfg, words);
+}
+
+/**
+ * Constructs the k most probable parse trees for the given words according to the given grammar. The Viterbi chart
+ * is filled as in ViterbiCYKParser; the next best derivations are then extracted lazily from the chart, so the extra
+ * work grows with k and with the part of the chart the k best trees visit, not with the size of the chart. The
+ * hypergraph of the derivations has no unary edges, so the grammar must be in Chomsky normal form without unary rules;
+ * a grammar converted with convertToChomskyNormalForm(false) is rejected, since the chart would score the unary
+ * chains the trees can not contain. The words are only read, and they are the leaves of the parse trees.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param words Words of the sentence to be parsed.
+ * @return Array list of at most k parse trees in decreasing order of probability.
+ * @throws invalid_argument if the grammar has unary rules.
+ */
+vector<ParseTree*> KBestCYKParser::parse(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words){
+    int i, wordCount = words.size(), startSymbolId = pCfg.getStartSymbolId();
+    vector<ParseTree*> parseTrees;
+    if (pCfg.hasUnaryRules()){
+        throw invalid_argument("KBestCYKParser needs a grammar in Chomsky normal form without unary rules");
+    }
+    if (wordCount == 0 || k <= 0){
+        return parseTrees;
+    }
+    fillChart(pCfg, words);
+    vertices.clear();
+    vertexIndex.clear();
+    if (startSymbolId != -1 && startSymbolId < pCfg.getNonTerminalCount() && chart.getScore(0, wordCount - 1, startSymbolId) > -MAXFLOAT){
+        int root = getVertex(0, wordCount - 1, startSymbolId);
+        for (i = 0; i < k && lazyKthBest(pCfg, root, i); i++){
+            auto* parseTree = new ParseTree(constructTree(pCfg, words, root, i));
+            parseTree->correctParents();
+            parseTree->removeXNodes();
+            parseTrees.emplace_back(parseTree);
+        }
+    }
+    return parseTrees;
+}
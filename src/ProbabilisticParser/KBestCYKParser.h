@@ -0,0 +1,57 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#ifndef SYNTACTICPARSER_KBESTCYKPARSER_H
+#define SYNTACTICPARSER_KBESTCYKPARSER_H
+
+#include <unordered_map>
+#include <unordered_set>
+#include "ViterbiCYKParser.h"
+
+struct KBestHyperedge {
+    int split;
+    int ruleIndex;
+    int leftVertex;
+    int rightVertex;
+    double score;
+};
+
+struct KBestDerivation {
+    int edge;
+    int leftRank;
+    int rightRank;
+    double score;
+};
+
+struct KBestVertex {
+    int start;
+    int end;
+    int symbolId;
+    bool expanded = false;
+    vector<KBestHyperedge> edges;
+    vector<KBestDerivation> derivations;
+    vector<KBestDerivation> candidates;
+    unordered_set<long long> seen;
+};
+
+class KBestCYKParser : public ViterbiCYKParser{
+private:
+    int k;
+    vector<KBestVertex> vertices;
+    unordered_map<long long, int> vertexIndex;
+    int getVertex(int i, int j, int symbolId);
+    [[nodiscard]] double getScore(int vertex, int rank) const;
+    void expandVertex(const ProbabilisticContextFreeGrammar& pCfg, int vertex);
+    void pushCandidate(int vertex, int edge, int leftRank, int rightRank);
+    void lazyNext(const ProbabilisticContextFreeGrammar& pCfg, int vertex, const KBestDerivation& derivation);
+    bool lazyKthBest(const ProbabilisticContextFreeGrammar& pCfg, int vertex, int rank);
+    ParseNode* constructTree(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words, int vertex, int rank);
+public:
+    explicit KBestCYKParser(int k);
+    vector<ParseTree*> parse(const ProbabilisticContextFreeGrammar& pCfg, const Sentence* sentence) override;
+    vector<ParseTree*> parse(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words);
+};
+
+
+#endif //SYNTACTICPARSER_KBESTCYKPARSER_H
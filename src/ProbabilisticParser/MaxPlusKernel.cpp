@@ -0,0 +1,61 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include "MaxPlusKernel.h"
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/**
+ * Scores all binary rules of a left child over a split point at once. The score of a rule is its log probability
+ * plus the score of the left child plus the score of its right child in the right cell; the rules whose score is
+ * larger than the current score of their parent in the parent cell are returned. With AVX2, four rules are scored at
+ * a time by gathering the scores of their right children and parents; otherwise the rules are scored one by one. The
+ * parent scores are not modified, so the caller must check every returned score against the parent again when it
+ * applies them in order, as two returned rules may share the same parent.
+ * @param block Binary rules with the same left child, from ProbabilisticContextFreeGrammar::getBinaryRulesWithLeftChild.
+ * @param leftScore Log probability of the left child in the left cell.
+ * @param rightScores Log probabilities of all non-terminals in the right cell, minus infinity for the absent ones.
+ * @param parentScores Log probabilities of all non-terminals in the parent cell, minus infinity for the absent ones.
+ * @param positions Output; positions of the improving rules in the block. Must have room for block.size entries.
+ * @param scores Output; scores of the improving rules. Must have room for block.size entries.
+ * @return Number of improving rules.
+ */
+int MaxPlusKernel::improve(const BinaryRuleBlock& block,
+                           double leftScore,
+                           const double* rightScores,
+                           const double* parentScores,
+                           int* positions,
+                           double* scores) {
+    int r = 0, count = 0;
+#ifdef __AVX2__
+    alignas(32) double lanes[4];
+    __m256d left = _mm256_set1_pd(leftScore);
+    for (; r + 4 <= block.size; r += 4){
+        __m128i rightChildren = _mm_loadu_si128((const __m128i*) (block.rightChildren + r));
+        __m128i parents = _mm_loadu_si128((const __m128i*) (block.parents + r));
+        __m256d score = _mm256_add_pd(_mm256_add_pd(_mm256_loadu_pd(block.logProbabilities + r), left), _mm256_i32gather_pd(rightScores, rightChildren, 8));
+        int mask = _mm256_movemask_pd(_mm256_cmp_pd(score, _mm256_i32gather_pd(parentScores, parents, 8), _CMP_GT_OQ));
+        if (mask != 0){
+            _mm256_store_pd(lanes, score);
+            for (int lane = 0; lane < 4; lane++){
+                if (mask & (1 << lane)){
+                    positions[count] = r + lane;
+                    scores[count] = lanes[lane];
+                    count++;
+                }
+            }
+        }
+    }
+#endif
+    for (; r < block.size; r++){
+        double score = block.logProbabilities[r] + leftScore + rightScores[block.rightChildren[r]];
+        if (score > parentScores[block.parents[r]]){
+            positions[count] = r;
+            scores[count] = score;
+            count++;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,21 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#ifndef SYNTACTICPARSER_MAXPLUSKERNEL_H
+#define SYNTACTICPARSER_MAXPLUSKERNEL_H
+
+#include "../ProbabilisticContextFreeGrammar/ProbabilisticContextFreeGrammar.h"
+
+class MaxPlusKernel {
+public:
+    static int improve(const BinaryRuleBlock& block,
+                       double leftScore,
+                       const double* rightScores,
+                       const double* parentScores,
+                       int* positions,
+                       double* scores);
+};
+
+
+#endif //SYNTACTICPARSER_MAXPLUSKERNEL_H
@@ -4,67 +4,285 @@
 
 #include "ProbabilisticCYKParser.h"
 
-#include "../SyntacticParser/PartialParseList.h"
+/**
+ * Enables or disables filling the chart in parallel. In parallel mode the cells are filled span length by span
+ * length; the cells of the same span length only read the cells of shorter spans, so they are filled in parallel on
+ * a pool of worker threads, each allocating its nodes from its own arena. The parse trees are the same as in the
+ * sequential mode.
+ * @param threadCount Number of worker threads. If it is 1 or less, the chart is filled sequentially.
+ */
+void ProbabilisticCYKParser::setThreadCount(int threadCount){
+    workerArenas.clear();
+    workerStatistics.clear();
+    pool.reset();
+    if (threadCount > 1){
+        pool = make_unique<WorkStealingPool>(threadCount);
+        for (int i = 0; i < threadCount; i++){
+            workerArenas.emplace_back(make_unique<ParseNodeArena>());
+        }
+        workerStatistics.resize(threadCount);
+    }
+}
+
+/**
+ * Sets the beam width of pruning. After a cell of the chart is filled, only the beamWidth most probable partial
+ * parses of the cell survive.
+ * @param beamWidth Maximum number of partial parses in a cell, 0 or less for no limit.
+ */
+void ProbabilisticCYKParser::setBeamWidth(int beamWidth){
+    this->beamWidth = beamWidth;
+}
+
+/**
+ * Sets the threshold of pruning. After a cell of the chart is filled, the partial parses whose log probability is
+ * more than threshold below the most probable partial parse of the cell are removed.
+ * @param threshold Maximum distance in log probability to the best partial parse of a cell, infinity for no
+ *                  threshold.
+ */
+void ProbabilisticCYKParser::setThreshold(double threshold){
+    this->threshold = threshold;
+}
+
+/**
+ * Sets whether pruning compares the partial parses by their figure of merit instead of their log probability. The
+ * figure of merit adds the outside estimate of the symbol of a partial parse, so that symbols which rarely lead to a
+ * complete parse are pruned first.
+ * @param figureOfMerit True to prune by the figure of merit, false to prune by the log probability.
+ */
+void ProbabilisticCYKParser::setFigureOfMerit(bool figureOfMerit){
+    this->figureOfMerit = figureOfMerit;
+}
+
+/**
+ * Decides whether the chart may contain partial parses of the given symbol over the span (i, j). The exhaustive
+ * parser allows every item; parsers which restrict the chart, such as CoarseToFineCYKParser, override it.
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @param symbolId Id of the non-terminal symbol.
+ * @return True, if the item may be built; false otherwise.
+ */
+bool ProbabilisticCYKParser::allowed(int i, int j, int symbolId) const{
+    return true;
+}
+
+/**
+ * Prunes the cell (i, j) of the chart with the beam width and the threshold of the parser. The cell spanning the
+ * whole sentence is never pruned, since its parse trees are the result of parsing.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ */
+void ProbabilisticCYKParser::pruneCell(const ProbabilisticContextFreeGrammar& pCfg, int i, int j){
+    static const vector<double> noEstimates;
+    if ((beamWidth > 0 || threshold != numeric_limits<double>::infinity()) && (i != 0 || j != chart.getWordCount() - 1)){
+        chart.get(i, j).prune(beamWidth, threshold, figureOfMerit ? pCfg.getOutsideEstimates() : noEstimates);
+    }
+}
+
+/**
+ * Applies the unary rules of the grammar to the partial parses of the cell (i, j). For the partial parse of every
+ * non-terminal Y, the chains X -> ... -> Y of the unary closure of Y, which are the most probable ones, are added on
+ * top of it, and the partial parse of X is replaced if the chain makes it more probable. The closure is applied only
+ * to the partial parses the cell had before, since the chains are already transitive. Chains through a symbol which
+ * is not allowed in the cell are skipped. The method does nothing if the grammar has no unary rules.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @param cellArena Arena the new partial parses are allocated from.
+ * @param cellStatistics Statistics the work is counted into, null if the work is not counted.
+ */
+void ProbabilisticCYKParser::applyUnaryClosure(const ProbabilisticContextFreeGrammar& pCfg, int i, int j, ParseNodeArena& cellArena, ParseStatistics* cellStatistics){
+    if (!pCfg.hasUnaryRules()){
+        return;
+    }
+    PartialParseList& cell = chart.get(i, j);
+    vector<pair<ArenaParseNode*, int>> partialParses;
+    vector<ArenaParseNode*> chainNodes;
+    for (int x = 0; x < cell.size(); x++){
+        partialParses.emplace_back(cell.getPartialParse(x), cell.getSymbolId(x));
+    }
+    for (const auto& [partialParse, symbolId] : partialParses){
+        pair<int, int> range = pCfg.getUnaryClosureRange(symbolId);
+        chainNodes.resize(range.second - range.first);
+        PARSE_STATISTICS_ADD(cellStatistics, ruleLookups, range.second - range.first);
+        for (int e = range.first; e < range.second; e++){
+            const UnaryClosureEntry& entry = pCfg.getUnaryClosureEntry(e);
+            ArenaParseNode* below = entry.below == -1 ? partialParse : chainNodes[entry.below - range.first];
+            if (below == nullptr || !allowed(i, j, entry.symbolId)){
+                chainNodes[e - range.first] = nullptr;
+                continue;
+            }
+            chainNodes[e - range.first] = cellArena.createProbabilisticParseNode(below, entry.symbolId, partialParse->logProbability + entry.logProbability);
+            PARSE_STATISTICS_UPDATE(cellStatistics, cell.updatePartialParse(chainNodes[e - range.first], entry.symbolId));
+        }
+    }
+}
+
+/**
+ * Fills the cell (i, j) of the chart by combining every pair of partial parses of the cells (i, k) and (k + 1, j)
+ * with the rules of the grammar, keeping only the most probable partial parses of every non-terminal, applies the
+ * unary rules of the grammar to the cell, and prunes the cell if pruning is enabled.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @param cellArena Arena the new partial parses are allocated from.
+ * @param cellStatistics Statistics the work is counted into, null if the work is not counted.
+ */
+void ProbabilisticCYKParser::fillCell(const ProbabilisticContextFreeGrammar& pCfg, int i, int j, ParseNodeArena& cellArena, ParseStatistics* cellStatistics){
+    int k, x, y;
+    ArenaParseNode* leftNode, *rightNode;
+    double probability;
+    span<Rule* const> candidates;
+    PartialParseList& cell = chart.get(i, j);
+    PARSE_STATISTICS_ADD(cellStatistics, cellsFilled, 1);
+    for (k = i; k < j; k++){
+        const PartialParseList& leftCell = chart.get(i, k);
+        const PartialParseList& rightCell = chart.get(k + 1, j);
+        PARSE_STATISTICS_ADD(cellStatistics, childPairs, leftCell.size() * rightCell.size());
+        for (x = 0; x < leftCell.size(); x++)
+            for (y = 0; y < rightCell.size(); y++){
+                leftNode = leftCell.getPartialParse(x);
+                rightNode = rightCell.getPartialParse(y);
+                candidates = pCfg.getRulesWithTwoNonTerminalsOnRightSide(leftCell.getSymbolId(x), rightCell.getSymbolId(y));
+                PARSE_STATISTICS_ADD(cellStatistics, ruleLookups, candidates.size());
+                for (Rule* candidate: candidates){
+                    if (!allowed(i, j, candidate->getLeftHandSideId())){
+                        continue;
+                    }
+                    probability = ((ProbabilisticRule*) candidate)->getLogProbability() + leftNode->logProbability + rightNode->logProbability;
+                    PARSE_STATISTICS_UPDATE(cellStatistics, cell.updatePartialParse(cellArena.createProbabilisticParseNode(leftNode, rightNode, candidate->getLeftHandSideId(), probability), candidate->getLeftHandSideId()));
+                }
+            }
+    }
+    applyUnaryClosure(pCfg, i, j, cellArena, cellStatistics);
+    pruneCell(pCfg, i, j);
+}
 
 /**
  * Constructs an array of most probable parse trees for a given sentence according to the given grammar. CYK parser
- * is based on a dynamic programming algorithm.
+ * is based on a dynamic programming algorithm. The words of the sentence are not changed.
  * @param pCfg Probabilistic context free grammar used in parsing.
  * @param sentence Sentence to be parsed.
  * @return Array list of most probable parse trees for the given sentence.
  */
 vector<ParseTree*> ProbabilisticCYKParser::parse(const ProbabilisticContextFreeGrammar& pCfg, const Sentence* sentence){
-    int i, j, k, x, y;
-    PartialParseList table[sentence->wordCount()][sentence->wordCount()];
-    ProbabilisticParseNode* leftNode, *rightNode;
-    double bestProbability, probability;
-    vector<Rule*> candidates;
+    return parse(pCfg, sentence, nullptr);
+}
+
+/**
+ * Constructs an array of most probable parse trees for a given sentence according to the given grammar, and counts
+ * the work of parsing into the given statistics. The words of the sentence are not changed.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param sentence Sentence to be parsed.
+ * @param statistics Statistics the work of parsing is added to, null if the work is not counted.
+ * @return Array list of most probable parse trees for the given sentence.
+ */
+vector<ParseTree*> ProbabilisticCYKParser::parse(const ProbabilisticContextFreeGrammar& pCfg, const Sentence* sentence, ParseStatistics* statistics){
+    vector<string> words;
+    for (int i = 0; i < sentence->wordCount(); i++){
+        words.emplace_back(sentence->getWord(i)->getName());
+    }
+    return parse(pCfg, words, statistics);
+}
+
+/**
+ * Constructs an array of most probable parse trees for the given words according to the given grammar. The words are
+ * only read: rare words and numbers are converted to the ids of _rare_ and _num_ in a separate buffer, and the words
+ * themselves are the leaves of the parse trees, so the same words can be parsed from many threads, each with its own
+ * parser.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param words Words of the sentence to be parsed.
+ * @return Array list of most probable parse trees for the given words.
+ */
+vector<ParseTree*> ProbabilisticCYKParser::parse(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words){
+    return parse(pCfg, words, nullptr);
+}
+
+/**
+ * Constructs an array of most probable parse trees for the given words according to the given grammar, and counts the
+ * work of parsing into the given statistics. A partial parse offered to a cell is counted as a created edge if the
+ * cell had no partial parse of its symbol, and as a replaced edge if it beats the partial parse of its symbol; the
+ * nodes of the rejected partial parses are still counted as allocated. In parallel mode every worker counts into its
+ * own statistics, which are added up after the chart is filled. Nothing is counted unless the library is built with
+ * SYNTACTICPARSER_STATISTICS.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param words Words of the sentence to be parsed.
+ * @param statistics Statistics the work of parsing is added to, null if the work is not counted.
+ * @return Array list of most probable parse trees for the given words.
+ */
+vector<ParseTree*> ProbabilisticCYKParser::parse(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words, ParseStatistics* statistics){
+    int i, j, startSymbolId = pCfg.getStartSymbolId(), wordCount = words.size();
+    double bestProbability;
+    span<Rule* const> candidates;
     vector<ParseTree*> parseTrees;
-    auto* backUp = new Sentence();
-    for (i = 0; i < sentence->wordCount(); i++){
-        backUp->addWord(new Word(sentence->getWord(i)->getName()));
+    if (wordCount == 0){
+        return parseTrees;
     }
-    pCfg.removeExceptionalWordsFromSentence(sentence);
-    for (i = 0; i < sentence->wordCount(); i++)
-        for (j = i; j < sentence->wordCount(); j++)
-            table[i][j] = PartialParseList();
-    for (i = 0; i < sentence->wordCount(); i++){
-        candidates = pCfg.getTerminalRulesWithRightSideX(Symbol(sentence->getWord(i)->getName()));
+    PARSE_STATISTICS_START(statistics);
+    PARSE_STATISTICS_ADD(statistics, sentenceCount, 1);
+    pCfg.normalizeWords(words, wordSymbolIds);
+    PARSE_STATISTICS_PHASE(statistics, normalizationTime);
+    chart.reset(wordCount);
+    for (i = 0; i < wordCount; i++){
+        candidates = pCfg.getTerminalRulesWithRightSideX(wordSymbolIds[i]);
+        PARSE_STATISTICS_ADD(statistics, cellsFilled, 1);
+        PARSE_STATISTICS_ADD(statistics, ruleLookups, candidates.size());
+        ArenaParseNode* leaf = candidates.empty() ? nullptr : arena.createParseNode(i);
         for (Rule* candidate: candidates){
-            table[i][i].addPartialParse(new ProbabilisticParseNode(new ParseNode(Symbol(sentence->getWord(i)->getName())), candidate->getLeftHandSide(), log(((ProbabilisticRule*) candidate)->getProbability())));
+            if (!allowed(i, i, candidate->getLeftHandSideId())){
+                continue;
+            }
+            chart.get(i, i).addPartialParse(arena.createProbabilisticParseNode(leaf, candidate->getLeftHandSideId(), ((ProbabilisticRule*) candidate)->getLogProbability()), candidate->getLeftHandSideId());
+            PARSE_STATISTICS_ADD(statistics, edgesCreated, 1);
         }
+        applyUnaryClosure(pCfg, i, i, arena, statistics);
+        pruneCell(pCfg, i, i);
     }
-    for (j = 1; j < sentence->wordCount(); j++){
-        for (i = j - 1; i >= 0; i--){
-            for (k = i; k < j; k++)
-                for (x = 0; x < table[i][k].size(); x++)
-                    for (y = 0; y < table[k + 1][j].size(); y++){
-                        leftNode = (ProbabilisticParseNode*) table[i][k].getPartialParse(x);
-                        rightNode = (ProbabilisticParseNode*) table[k + 1][j].getPartialParse(y);
-                        candidates = pCfg.getRulesWithTwoNonTerminalsOnRightSide(leftNode->getData(), rightNode->getData());
-                        for (Rule* candidate: candidates){
-                            probability = log(((ProbabilisticRule*) candidate)->getProbability()) + leftNode->getLogProbability() + rightNode->getLogProbability();
-                            table[i][j].updatePartialParse(new ProbabilisticParseNode(leftNode, rightNode, candidate->getLeftHandSide(), probability));
-                        }
-                    }
+    PARSE_STATISTICS_PHASE(statistics, lexicalFillTime);
+    if (pool == nullptr){
+        for (j = 1; j < wordCount; j++){
+            for (i = j - 1; i >= 0; i--){
+                fillCell(pCfg, i, j, arena, statistics);
+            }
+        }
+    } else {
+        for (int length = 1; length < wordCount; length++){
+            pool->parallelFor(wordCount - length, [&](int start, int worker){
+                fillCell(pCfg, start, start + length, *workerArenas[worker], statistics == nullptr ? nullptr : &workerStatistics[worker]);
+            });
+        }
+    }
+#ifdef SYNTACTICPARSER_STATISTICS
+    if (statistics != nullptr){
+        statistics->nodesAllocated += arena.size();
+        for (int worker = 0; worker < workerStatistics.size(); worker++){
+            statistics->add(workerStatistics[worker]);
+            statistics->nodesAllocated += workerArenas[worker]->size();
+            workerStatistics[worker].clear();
         }
+        statistics->peakChartSize = max(statistics->peakChartSize, (long long) chart.size());
     }
+#endif
+    PARSE_STATISTICS_PHASE(statistics, binaryFillTime);
+    const PartialParseList& root = chart.get(0, wordCount - 1);
     bestProbability = -MAXFLOAT;
-    for (i = 0; i < table[0][sentence->wordCount() - 1].size(); i++){
-        if (table[0][sentence->wordCount() - 1].getPartialParse(i)->getData().getName() == "S" && ((ProbabilisticParseNode*) table[0][sentence->wordCount() - 1].getPartialParse(i))->getLogProbability() > bestProbability) {
-            bestProbability = ((ProbabilisticParseNode*) table[0][sentence->wordCount() - 1].getPartialParse(i))->getLogProbability();
+    for (i = 0; i < root.size(); i++){
+        if (root.getSymbolId(i) == startSymbolId && root.getPartialParse(i)->logProbability > bestProbability) {
+            bestProbability = root.getPartialParse(i)->logProbability;
         }
     }
-    for (i = 0; i < table[0][sentence->wordCount() - 1].size(); i++){
-        if (table[0][sentence->wordCount() - 1].getPartialParse(i)->getData().getName() == "S" && ((ProbabilisticParseNode*) table[0][sentence->wordCount() - 1].getPartialParse(i))->getLogProbability() == bestProbability) {
-            auto* parseTree = new ParseTree(table[0][sentence->wordCount() - 1].getPartialParse(i));
+    for (i = 0; i < root.size(); i++){
+        if (root.getSymbolId(i) == startSymbolId && root.getPartialParse(i)->logProbability == bestProbability) {
+            auto* parseTree = new ParseTree(ParseNodeArena::copyTree(root.getPartialParse(i), pCfg, words, true));
             parseTree->correctParents();
             parseTree->removeXNodes();
             parseTrees.emplace_back(parseTree);
         }
     }
-    for (ParseTree* parseTree : parseTrees){
-        pCfg.reinsertExceptionalWordsFromSentence(parseTree, backUp);
+    PARSE_STATISTICS_PHASE(statistics, treeExtractionTime);
+    arena.reset();
+    for (unique_ptr<ParseNodeArena>& workerArena : workerArenas){
+        workerArena->reset();
     }
     return parseTrees;
-}
\ No newline at end of file
+}
@@ -6,11 +6,38 @@
 #define SYNTACTICPARSER_PROBABILISTICCYKPARSER_H
 
 
+#include <limits>
 #include "ProbabilisticParser.h"
+#include "../SyntacticParser/PartialParseChart.h"
+#include "../SyntacticParser/ParseNodeArena.h"
+#include "../SyntacticParser/WorkStealingPool.h"
+#include "../SyntacticParser/ParseStatistics.h"
 
 class ProbabilisticCYKParser : public ProbabilisticParser{
+private:
+    PartialParseChart chart;
+    ParseNodeArena arena;
+    unique_ptr<WorkStealingPool> pool;
+    vector<unique_ptr<ParseNodeArena>> workerArenas;
+    vector<ParseStatistics> workerStatistics;
+    int beamWidth = 0;
+    double threshold = numeric_limits<double>::infinity();
+    bool figureOfMerit = false;
+    vector<int> wordSymbolIds;
+    void fillCell(const ProbabilisticContextFreeGrammar& pCfg, int i, int j, ParseNodeArena& cellArena, ParseStatistics* cellStatistics);
+    void pruneCell(const ProbabilisticContextFreeGrammar& pCfg, int i, int j);
+    void applyUnaryClosure(const ProbabilisticContextFreeGrammar& pCfg, int i, int j, ParseNodeArena& cellArena, ParseStatistics* cellStatistics);
+protected:
+    [[nodiscard]] virtual bool allowed(int i, int j, int symbolId) const;
 public:
+    void setThreadCount(int threadCount);
+    void setBeamWidth(int beamWidth);
+    void setThreshold(double threshold);
+    void setFigureOfMerit(bool figureOfMerit);
     vector<ParseTree*> parse(const ProbabilisticContextFreeGrammar& pCfg, const Sentence* sentence);
+    vector<ParseTree*> parse(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words);
+    vector<ParseTree*> parse(const ProbabilisticContextFreeGrammar& pCfg, const Sentence* sentence, ParseStatistics* statistics);
+    vector<ParseTree*> parse(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words, ParseStatistics* statistics);
 };
 
 
@@ -10,7 +10,8 @@
 
 class ProbabilisticParser {
 public:
-    vector<ParseTree*> parse(const ProbabilisticContextFreeGrammar& pCfg, Sentence* sentence);
+    virtual ~ProbabilisticParser() = default;
+    virtual vector<ParseTree*> parse(const ProbabilisticContextFreeGrammar& pCfg, const Sentence* sentence) = 0;
 };
 
 
@@ -0,0 +1,164 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include "ViterbiCYKParser.h"
+#include "MaxPlusKernel.h"
+
+#include "../ProbabilisticContextFreeGrammar/ProbabilisticParseNode.h"
+
+/**
+ * Constructs the subtree of the best derivation of the given symbol over the span (i, j) by following the
+ * backpointers in the chart.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param words Words of the sentence, the leaves of the tree.
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @param symbolId Id of the non-terminal symbol at the root of the subtree.
+ * @return Root of the subtree of the best derivation.
+ */
+ParseNode* ViterbiCYKParser::constructTree(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words, int i, int j, int symbolId) const{
+    int split = chart.getSplit(i, j, symbolId);
+    if (split == -2){
+        vector<int> chain;
+        for (int entry = chart.getRuleIndex(i, j, symbolId); entry != -1; entry = pCfg.getUnaryClosureEntry(entry).below){
+            chain.emplace_back(entry);
+        }
+        int bottomSymbolId = pCfg.getUnaryClosureEntry(chain.back()).rule->getRightHandSideIdAt(0);
+        ParseNode* node = constructTree(pCfg, words, i, j, bottomSymbolId);
+        for (int k = chain.size() - 1; k >= 0; k--){
+            const UnaryClosureEntry& entry = pCfg.getUnaryClosureEntry(chain[k]);
+            node = new ProbabilisticParseNode(node, pCfg.getSymbol(entry.symbolId), chart.getScore(i, j, bottomSymbolId) + entry.logProbability);
+        }
+        return node;
+    }
+    if (split == -1){
+        return new ProbabilisticParseNode(new ParseNode(Symbol(words[i])), pCfg.getSymbol(symbolId), chart.getScore(i, j, symbolId));
+    }
+    Rule* rule = pCfg.getBinaryRule(chart.getRuleIndex(i, j, symbolId));
+    ParseNode* left = constructTree(pCfg, words, i, split, rule->getRightHandSideIdAt(0));
+    ParseNode* right = constructTree(pCfg, words, split + 1, j, rule->getRightHandSideIdAt(1));
+    return new ProbabilisticParseNode(left, right, pCfg.getSymbol(symbolId), chart.getScore(i, j, symbolId));
+}
+
+/**
+ * Applies the unary rules of the grammar to the cell (i, j) of the chart. For every non-terminal Y of the cell, the
+ * chains X -> ... -> Y of the unary closure of Y replace the best derivation of X if they are more probable. The
+ * scores of the cell are copied before, so that every chain starts from a derivation which is not itself a chain,
+ * and following the backpointers always ends. The method does nothing if the grammar has no unary rules.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ */
+void ViterbiCYKParser::applyUnaryClosure(const ProbabilisticContextFreeGrammar& pCfg, int i, int j){
+    if (!pCfg.hasUnaryRules()){
+        return;
+    }
+    unaryBase.clear();
+    for (int symbolId : chart.getActiveSymbols(i, j)){
+        unaryBase.emplace_back(symbolId, chart.getScore(i, j, symbolId));
+    }
+    for (const auto& [symbolId, score] : unaryBase){
+        pair<int, int> range = pCfg.getUnaryClosureRange(symbolId);
+        for (int e = range.first; e < range.second; e++){
+            const UnaryClosureEntry& entry = pCfg.getUnaryClosureEntry(e);
+            chart.update(i, j, entry.symbolId, score + entry.logProbability, -2, e);
+        }
+    }
+}
+
+/**
+ * Fills the chart bottom up with the best log probability of every non-terminal over every span of the sentence,
+ * together with the split point and the rule of its best derivation. For every split point and every left child, all
+ * binary rules of the left child are scored at once against the dense score arrays of the right and parent cells by
+ * the MaxPlusKernel. The unary rules of the grammar are applied to every cell after its binary rules. The words are
+ * only read: rare words and numbers are converted to the ids of _rare_ and _num_ in a separate buffer.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param words Words of the sentence to be parsed.
+ */
+void ViterbiCYKParser::fillChart(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words){
+    int i, j, k, r, count, wordCount = words.size();
+    pair<int, int> range;
+    pCfg.normalizeWords(words, wordSymbolIds);
+    chart.reset(wordCount, pCfg.getNonTerminalCount());
+    for (i = 0; i < wordCount; i++){
+        range = pCfg.getTerminalRuleRange(wordSymbolIds[i]);
+        for (r = range.first; r < range.second; r++){
+            Rule* candidate = pCfg.getTerminalRule(r);
+            chart.update(i, i, candidate->getLeftHandSideId(), ((ProbabilisticRule*) candidate)->getLogProbability(), -1, r);
+        }
+        applyUnaryClosure(pCfg, i, i);
+    }
+    for (j = 1; j < wordCount; j++){
+        for (i = j - 1; i >= 0; i--){
+            for (k = i; k < j; k++){
+                if (chart.getActiveSymbols(k + 1, j).empty()){
+                    continue;
+                }
+                for (int leftSymbol : chart.getActiveSymbols(i, k)){
+                    BinaryRuleBlock block = pCfg.getBinaryRulesWithLeftChild(leftSymbol);
+                    if (improvedRules.size() < block.size){
+                        improvedRules.resize(block.size);
+                        improvedScores.resize(block.size);
+                    }
+                    count = MaxPlusKernel::improve(block, chart.getScore(i, k, leftSymbol), chart.getScores(k + 1, j), chart.getScores(i, j), improvedRules.data(), improvedScores.data());
+                    for (r = 0; r < count; r++){
+                        chart.update(i, j, block.parents[improvedRules[r]], improvedScores[r], k, block.ruleIndexes[improvedRules[r]]);
+                    }
+                }
+            }
+            applyUnaryClosure(pCfg, i, j);
+        }
+    }
+}
+
+/**
+ * Accessor for the chart filled by the last call of fillChart.
+ * @return Viterbi chart of the last sentence.
+ */
+const ViterbiChart& ViterbiCYKParser::getChart() const{
+    return chart;
+}
+
+/**
+ * Constructs the most probable parse tree for a given sentence according to the given grammar. Unlike
+ * ProbabilisticCYKParser, every cell of the chart stores only the best log probability of every non-terminal together
+ * with the split point and the rule of its best derivation; parse nodes are created only for the most probable tree
+ * at the end. The words of the sentence are not changed.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param sentence Sentence to be parsed.
+ * @return Array list containing the most probable parse tree for the given sentence, empty if the sentence can not
+ * be parsed.
+ */
+vector<ParseTree*> ViterbiCYKParser::parse(const ProbabilisticContextFreeGrammar& pCfg, const Sentence* sentence){
+    vector<string> words;
+    for (int i = 0; i < sentence->wordCount(); i++){
+        words.emplace_back(sentence->getWord(i)->getName());
+    }
+    return parse(pCfg, words);
+}
+
+/**
+ * Constructs the most probable parse tree for the given words according to the given grammar. The words are only
+ * read, and they are the leaves of the parse tree, so the same words can be parsed from many threads, each with its
+ * own parser.
+ * @param pCfg Probabilistic context free grammar used in parsing.
+ * @param words Words of the sentence to be parsed.
+ * @return Array list containing the most probable parse tree for the given words, empty if the words can not be
+ * parsed.
+ */
+vector<ParseTree*> ViterbiCYKParser::parse(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words){
+    int wordCount = words.size(), startSymbolId = pCfg.getStartSymbolId();
+    vector<ParseTree*> parseTrees;
+    if (wordCount == 0){
+        return parseTrees;
+    }
+    fillChart(pCfg, words);
+    if (startSymbolId != -1 && startSymbolId < pCfg.getNonTerminalCount() && chart.getScore(0, wordCount - 1, startSymbolId) > -MAXFLOAT){
+        auto* parseTree = new ParseTree(constructTree(pCfg, words, 0, wordCount - 1, startSymbolId));
+        parseTree->correctParents();
+        parseTree->removeXNodes();
+        parseTrees.emplace_back(parseTree);
+    }
+    return parseTrees;
+}
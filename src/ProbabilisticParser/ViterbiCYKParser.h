@@ -0,0 +1,30 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#ifndef SYNTACTICPARSER_VITERBICYKPARSER_H
+#define SYNTACTICPARSER_VITERBICYKPARSER_H
+
+
+#include "ProbabilisticParser.h"
+#include "ViterbiChart.h"
+
+class ViterbiCYKParser : public ProbabilisticParser{
+protected:
+    ViterbiChart chart;
+    vector<int> improvedRules;
+    vector<double> improvedScores;
+    vector<pair<int, double>> unaryBase;
+    vector<int> wordSymbolIds;
+    void applyUnaryClosure(const ProbabilisticContextFreeGrammar& pCfg, int i, int j);
+private:
+    ParseNode* constructTree(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words, int i, int j, int symbolId) const;
+public:
+    void fillChart(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words);
+    [[nodiscard]] const ViterbiChart& getChart() const;
+    vector<ParseTree*> parse(const ProbabilisticContextFreeGrammar& pCfg, const Sentence* sentence) override;
+    vector<ParseTree*> parse(const ProbabilisticContextFreeGrammar& pCfg, span<const string> words);
+};
+
+
+#endif //SYNTACTICPARSER_VITERBICYKPARSER_H
@@ -0,0 +1,128 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include "ViterbiChart.h"
+#include <limits>
+
+/**
+ * Prepares the chart for a new sentence. Every cell (i, j) with i <= j of the chart stores a score array indexed by
+ * the non-terminal ids of the grammar, and the backpointers of the best derivation of every non-terminal. The arrays
+ * of the previous sentence are reused; only the entries which were filled for the previous sentence are cleared.
+ * @param wordCount Number of words in the sentence.
+ * @param nonTerminalCount Number of non-terminal symbols in the grammar.
+ */
+void ViterbiChart::reset(int wordCount, int nonTerminalCount) {
+    int cellCount = wordCount * (wordCount + 1) / 2;
+    if (nonTerminalCount != this->nonTerminalCount || cellCount > activeSymbols.size()){
+        scores.assign((size_t) cellCount * nonTerminalCount, -numeric_limits<double>::infinity());
+        splits.resize((size_t) cellCount * nonTerminalCount);
+        ruleIndexes.resize((size_t) cellCount * nonTerminalCount);
+        activeSymbols.resize(cellCount);
+        for (vector<int>& active : activeSymbols){
+            active.clear();
+        }
+    } else {
+        for (int cell = 0; cell < activeSymbols.size(); cell++){
+            for (int symbolId : activeSymbols[cell]){
+                scores[(size_t) cell * nonTerminalCount + symbolId] = -numeric_limits<double>::infinity();
+            }
+            activeSymbols[cell].clear();
+        }
+    }
+    this->wordCount = wordCount;
+    this->nonTerminalCount = nonTerminalCount;
+}
+
+/**
+ * Returns the position of the cell (i, j) in the chart. Only the cells with i <= j are stored, row by row.
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @return Position of the cell (i, j).
+ */
+int ViterbiChart::cellIndex(int i, int j) const {
+    return i * wordCount - i * (i - 1) / 2 + (j - i);
+}
+
+/**
+ * Returns the logarithm of the probability of the best derivation of the given symbol over the span (i, j).
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @param symbolId Id of the non-terminal symbol.
+ * @return Best log probability, minus infinity if the symbol can not derive the span.
+ */
+double ViterbiChart::getScore(int i, int j, int symbolId) const {
+    return scores[(size_t) cellIndex(i, j) * nonTerminalCount + symbolId];
+}
+
+/**
+ * Returns the log probabilities of all non-terminals over the span (i, j) as a dense array indexed by the
+ * non-terminal ids.
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @return Log probabilities of the non-terminals in the cell (i, j), minus infinity for the absent ones.
+ */
+const double* ViterbiChart::getScores(int i, int j) const {
+    return scores.data() + (size_t) cellIndex(i, j) * nonTerminalCount;
+}
+
+/**
+ * Returns the split point of the best derivation of the given symbol over the span (i, j). The best derivation
+ * combines the spans (i, split) and (split + 1, j).
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @param symbolId Id of the non-terminal symbol.
+ * @return Split point of the best derivation, -1 if the best derivation is a terminal rule, -2 if it is a chain of
+ * unary rules over another symbol of the same span.
+ */
+int ViterbiChart::getSplit(int i, int j, int symbolId) const {
+    return splits[(size_t) cellIndex(i, j) * nonTerminalCount + symbolId];
+}
+
+/**
+ * Returns the position of the rule of the best derivation of the given symbol over the span (i, j) in the binary
+ * rule index of the grammar, in the terminal rule index if the split point is -1, or the position of the unary closure
+ * entry of the chain if the split point is -2.
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @param symbolId Id of the non-terminal symbol.
+ * @return Position of the rule of the best derivation.
+ */
+int ViterbiChart::getRuleIndex(int i, int j, int symbolId) const {
+    return ruleIndexes[(size_t) cellIndex(i, j) * nonTerminalCount + symbolId];
+}
+
+/**
+ * Returns the ids of the non-terminal symbols which derive the span (i, j).
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @return Ids of the non-terminal symbols in the cell (i, j).
+ */
+const vector<int>& ViterbiChart::getActiveSymbols(int i, int j) const {
+    return activeSymbols[cellIndex(i, j)];
+}
+
+/**
+ * Replaces the best derivation of the given symbol over the span (i, j), if the new derivation is more probable.
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @param symbolId Id of the non-terminal symbol.
+ * @param score Logarithm of the probability of the new derivation.
+ * @param split Split point of the new derivation, -1 for a terminal rule, -2 for a chain of unary rules.
+ * @param ruleIndex Position of the rule of the new derivation in the rule index of the grammar.
+ * @return True, if the new derivation replaced the previous one; false otherwise.
+ */
+bool ViterbiChart::update(int i, int j, int symbolId, double score, int split, int ruleIndex) {
+    int cell = cellIndex(i, j);
+    size_t position = (size_t) cell * nonTerminalCount + symbolId;
+    if (score <= scores[position]){
+        return false;
+    }
+    if (scores[position] == -numeric_limits<double>::infinity()){
+        activeSymbols[cell].emplace_back(symbolId);
+    }
+    scores[position] = score;
+    splits[position] = split;
+    ruleIndexes[position] = ruleIndex;
+    return true;
+}
@@ -0,0 +1,33 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#ifndef SYNTACTICPARSER_VITERBICHART_H
+#define SYNTACTICPARSER_VITERBICHART_H
+
+#include <vector>
+
+using namespace std;
+
+class ViterbiChart {
+private:
+    int wordCount = 0;
+    int nonTerminalCount = 0;
+    vector<double> scores;
+    vector<int> splits;
+    vector<int> ruleIndexes;
+    vector<vector<int>> activeSymbols;
+public:
+    ViterbiChart() = default;
+    void reset(int wordCount, int nonTerminalCount);
+    [[nodiscard]] int cellIndex(int i, int j) const;
+    [[nodiscard]] double getScore(int i, int j, int symbolId) const;
+    [[nodiscard]] const double* getScores(int i, int j) const;
+    [[nodiscard]] int getSplit(int i, int j, int symbolId) const;
+    [[nodiscard]] int getRuleIndex(int i, int j, int symbolId) const;
+    [[nodiscard]] const vector<int>& getActiveSymbols(int i, int j) const;
+    bool update(int i, int j, int symbolId, double score, int split, int ruleIndex);
+};
+
+
+#endif //SYNTACTICPARSER_VITERBICHART_H
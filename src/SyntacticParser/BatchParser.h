@@ -0,0 +1,111 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#ifndef SYNTACTICPARSER_BATCHPARSER_H
+#define SYNTACTICPARSER_BATCHPARSER_H
+
+#include <memory>
+#include "Corpus.h"
+#include "ParseTree.h"
+#include "WorkStealingPool.h"
+#include "ParseStatistics.h"
+
+/**
+ * Parses many sentences in parallel with a fixed pool of worker threads. Every worker owns its own parser, so the
+ * charts and arenas of a parser are reused by all sentences the worker parses, while the grammar is shared read only
+ * by all workers. Parser is CYKParser or one of the ProbabilisticParser classes, and Grammar is the grammar type its
+ * parse method accepts.
+ */
+template <class Parser, class Grammar> class BatchParser {
+private:
+    WorkStealingPool pool;
+    vector<unique_ptr<Parser>> parsers;
+public:
+    template <class... Args> explicit BatchParser(int threadCount, const Args&... args);
+    [[nodiscard]] int getThreadCount() const;
+    vector<vector<ParseTree*>> parse(const Grammar& grammar, const vector<Sentence*>& sentences);
+    vector<vector<ParseTree*>> parse(const Grammar& grammar, const Corpus& corpus);
+    vector<vector<ParseTree*>> parse(const Grammar& grammar, const vector<Sentence*>& sentences, ParseStatistics* statistics);
+};
+
+/**
+ * Constructor for the batch parser. Starts the worker threads and creates one parser for every worker.
+ * @param threadCount Number of worker threads. If it is not positive, the number of hardware threads is used.
+ * @param args Arguments passed to the constructor of every parser, such as k of a KBestCYKParser.
+ */
+template<class Parser, class Grammar>
+template<class... Args>
+BatchParser<Parser, Grammar>::BatchParser(int threadCount, const Args&... args) : pool(threadCount) {
+    for (int i = 0; i < pool.getThreadCount(); i++){
+        parsers.emplace_back(make_unique<Parser>(args...));
+    }
+}
+
+/**
+ * Returns number of worker threads.
+ * @return Number of worker threads.
+ */
+template<class Parser, class Grammar>
+int BatchParser<Parser, Grammar>::getThreadCount() const {
+    return pool.getThreadCount();
+}
+
+/**
+ * Parses the given sentences in parallel. As in the parse methods of the parsers, the sentences are only read: rare
+ * words and numbers are converted to the ids of _rare_ and _num_ in the buffers of the workers, so the sentences are
+ * not changed and can be shared with other readers while they are parsed.
+ * @param grammar Grammar used in parsing. It is only read, so it is shared by all workers.
+ * @param sentences Sentences to be parsed.
+ * @return Parse trees of every sentence, in the order of the sentences.
+ */
+template<class Parser, class Grammar>
+vector<vector<ParseTree*>> BatchParser<Parser, Grammar>::parse(const Grammar& grammar, const vector<Sentence*>& sentences) {
+    vector<vector<ParseTree*>> result(sentences.size());
+    pool.parallelFor(sentences.size(), [&](int index, int worker){
+        result[index] = parsers[worker]->parse(grammar, sentences[index]);
+    });
+    return result;
+}
+
+/**
+ * Parses the sentences of the given corpus in parallel.
+ * @param grammar Grammar used in parsing. It is only read, so it is shared by all workers.
+ * @param corpus Corpus whose sentences will be parsed.
+ * @return Parse trees of every sentence, in the order of the sentences in the corpus.
+ */
+template<class Parser, class Grammar>
+vector<vector<ParseTree*>> BatchParser<Parser, Grammar>::parse(const Grammar& grammar, const Corpus& corpus) {
+    vector<Sentence*> sentences;
+    for (int i = 0; i < corpus.sentenceCount(); i++){
+        sentences.emplace_back(corpus.getSentence(i));
+    }
+    return parse(grammar, sentences);
+}
+
+/**
+ * Parses the given sentences in parallel and adds the statistics of parsing all of them to the given statistics.
+ * Every worker counts into its own statistics, and the statistics of the workers are added in worker order, so the
+ * phase times are the sums of the times of the workers. Parser must be CYKParser or ProbabilisticCYKParser.
+ * @param grammar Grammar used in parsing. It is only read, so it is shared by all workers.
+ * @param sentences Sentences to be parsed.
+ * @param statistics Statistics the work of parsing is added to, null if the work is not counted.
+ * @return Parse trees of every sentence, in the order of the sentences.
+ */
+template<class Parser, class Grammar>
+vector<vector<ParseTree*>> BatchParser<Parser, Grammar>::parse(const Grammar& grammar, const vector<Sentence*>& sentences, ParseStatistics* statistics) {
+    vector<vector<ParseTree*>> result(sentences.size());
+    vector<ParseStatistics> workerStatistics(pool.getThreadCount());
+    pool.parallelFor(sentences.size(), [&](int index, int worker){
+        result[index] = parsers[worker]->parse(grammar, sentences[index], statistics == nullptr ? nullptr : &workerStatistics[worker]);
+    });
+    if (statistics != nullptr){
+        for (const ParseStatistics& current : workerStatistics){
+            statistics->add(current);
+        }
+    }
+    return result;
+}
+
+
+#endif //SYNTACTICPARSER_BATCHPARSER_H
@@ -2,60 +2,275 @@
 // Created by Olcay Taner YILDIZ on 19.02.2024.
 //
 
+#include <stdexcept>
 #include "CYKParser.h"
-#include "PartialParseList.h"
+
+/**
+ * Enables or disables filling the chart in parallel. In parallel mode the cells are filled span length by span
+ * length; the cells of the same span length only read the cells of shorter spans, so they are filled in parallel on
+ * a pool of worker threads, each allocating its nodes from its own arena. The parse trees are the same as in the
+ * sequential mode.
+ * @param threadCount Number of worker threads. If it is 1 or less, the chart is filled sequentially.
+ */
+void CYKParser::setThreadCount(int threadCount){
+    workerArenas.clear();
+    workerStatistics.clear();
+    pool.reset();
+    if (threadCount > 1){
+        pool = make_unique<WorkStealingPool>(threadCount);
+        for (int i = 0; i < threadCount; i++){
+            workerArenas.emplace_back(make_unique<ParseNodeArena>());
+        }
+        workerStatistics.resize(threadCount);
+    }
+}
+
+/**
+ * Applies the unary rules of the grammar to the partial parses of the cell (i, j). For every partial parse of a
+ * non-terminal Y, a partial parse is added for every chain X -> ... -> Y of the unary closure of Y, sharing the nodes
+ * of the chain below it. The closure is applied only to the partial parses the cell had before, since the chains are
+ * already transitive. The method does nothing if the grammar has no unary rules.
+ * @param cfg Context free grammar used in parsing.
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @param cellArena Arena the new partial parses are allocated from.
+ * @param cellStatistics Statistics the work is counted into, null if the work is not counted.
+ */
+void CYKParser::applyUnaryClosure(const ContextFreeGrammar& cfg, int i, int j, ParseNodeArena& cellArena, ParseStatistics* cellStatistics){
+    if (!cfg.hasUnaryRules()){
+        return;
+    }
+    PartialParseList& cell = chart.get(i, j);
+    vector<ArenaParseNode*> chainNodes;
+    int size = cell.size();
+    for (int x = 0; x < size; x++){
+        pair<int, int> range = cfg.getUnaryClosureRange(cell.getSymbolId(x));
+        chainNodes.resize(range.second - range.first);
+        PARSE_STATISTICS_ADD(cellStatistics, ruleLookups, range.second - range.first);
+        PARSE_STATISTICS_ADD(cellStatistics, edgesCreated, range.second - range.first);
+        for (int e = range.first; e < range.second; e++){
+            const UnaryClosureEntry& entry = cfg.getUnaryClosureEntry(e);
+            ArenaParseNode* below = entry.below == -1 ? cell.getPartialParse(x) : chainNodes[entry.below - range.first];
+            chainNodes[e - range.first] = cellArena.createParseNode(below, entry.symbolId);
+            cell.addPartialParse(chainNodes[e - range.first], entry.symbolId);
+        }
+    }
+}
+
+/**
+ * Fills the cell (i, j) of the chart by combining every pair of partial parses of the cells (i, k) and (k + 1, j)
+ * with the rules of the grammar, and then applies the unary rules of the grammar to the cell.
+ * @param cfg Context free grammar used in parsing.
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @param cellArena Arena the new partial parses are allocated from.
+ * @param cellStatistics Statistics the work is counted into, null if the work is not counted.
+ */
+void CYKParser::fillCell(const ContextFreeGrammar& cfg, int i, int j, ParseNodeArena& cellArena, ParseStatistics* cellStatistics){
+    int k, x, y;
+    ArenaParseNode *leftNode, *rightNode;
+    span<Rule* const> candidates;
+    PartialParseList& cell = chart.get(i, j);
+    PARSE_STATISTICS_ADD(cellStatistics, cellsFilled, 1);
+    for (k = i; k < j; k++){
+        const PartialParseList& leftCell = chart.get(i, k);
+        const PartialParseList& rightCell = chart.get(k + 1, j);
+        PARSE_STATISTICS_ADD(cellStatistics, childPairs, leftCell.size() * rightCell.size());
+        for (x = 0; x < leftCell.size(); x++)
+            for (y = 0; y < rightCell.size(); y++){
+                leftNode = leftCell.getPartialParse(x);
+                rightNode = rightCell.getPartialParse(y);
+                candidates = cfg.getRulesWithTwoNonTerminalsOnRightSide(leftCell.getSymbolId(x), rightCell.getSymbolId(y));
+                PARSE_STATISTICS_ADD(cellStatistics, ruleLookups, candidates.size());
+                PARSE_STATISTICS_ADD(cellStatistics, edgesCreated, candidates.size());
+                for (Rule* candidate: candidates){
+                    cell.addPartialParse(cellArena.createParseNode(leftNode, rightNode, candidate->getLeftHandSideId()), candidate->getLeftHandSideId());
+                }
+            }
+    }
+    applyUnaryClosure(cfg, i, j, cellArena, cellStatistics);
+}
 
 /**
  * Constructs an array of possible parse trees for a given sentence according to the given grammar. CYK parser
- * is based on a dynamic programming algorithm.
+ * is based on a dynamic programming algorithm. The words of the sentence are not changed.
  * @param cfg Context free grammar used in parsing.
  * @param sentence Sentence to be parsed.
  * @return Array list of possible parse trees for the given sentence.
  */
 vector<ParseTree*> CYKParser::parse(const ContextFreeGrammar& cfg, Sentence* sentence){
-    int i, j, k, x, y;
-    PartialParseList table[sentence->wordCount()][sentence->wordCount()];
-    ParseNode *leftNode, *rightNode;
-    vector<Rule*> candidates;
+    return parse(cfg, sentence, nullptr);
+}
+
+/**
+ * Constructs an array of possible parse trees for a given sentence according to the given grammar, and counts the
+ * work of parsing into the given statistics. The words of the sentence are not changed.
+ * @param cfg Context free grammar used in parsing.
+ * @param sentence Sentence to be parsed.
+ * @param statistics Statistics the work of parsing is added to, null if the work is not counted.
+ * @return Array list of possible parse trees for the given sentence.
+ */
+vector<ParseTree*> CYKParser::parse(const ContextFreeGrammar& cfg, Sentence* sentence, ParseStatistics* statistics){
+    vector<string> words;
+    for (int i = 0; i < sentence->wordCount(); i++){
+        words.emplace_back(sentence->getWord(i)->getName());
+    }
+    return parse(cfg, words, statistics);
+}
+
+/**
+ * Constructs an array of possible parse trees for the given words according to the given grammar. The words are
+ * only read: rare words and numbers are converted to the ids of _rare_ and _num_ in a separate buffer, and the words
+ * themselves are the leaves of the parse trees, so the same words can be parsed from many threads, each with its own
+ * parser.
+ * @param cfg Context free grammar used in parsing.
+ * @param words Words of the sentence to be parsed.
+ * @return Array list of possible parse trees for the given words.
+ */
+vector<ParseTree*> CYKParser::parse(const ContextFreeGrammar& cfg, span<const string> words){
+    return parse(cfg, words, nullptr);
+}
+
+/**
+ * Constructs an array of possible parse trees for the given words according to the given grammar, and counts the
+ * work of parsing into the given statistics: the cells, child pairs, rule lookups, edges and nodes, the size of the
+ * filled chart, and the wall time of normalizing the words, filling the lexical cells, filling the longer spans and
+ * extracting the trees. In parallel mode every worker counts into its own statistics, which are added up after the
+ * chart is filled. Nothing is counted unless the library is built with SYNTACTICPARSER_STATISTICS.
+ * @param cfg Context free grammar used in parsing.
+ * @param words Words of the sentence to be parsed.
+ * @param statistics Statistics the work of parsing is added to, null if the work is not counted.
+ * @return Array list of possible parse trees for the given words.
+ */
+vector<ParseTree*> CYKParser::parse(const ContextFreeGrammar& cfg, span<const string> words, ParseStatistics* statistics){
+    int i, j, startSymbolId = cfg.getStartSymbolId(), wordCount = words.size();
+    span<Rule* const> candidates;
     vector<ParseTree*> parseTrees;
-    auto* backUp = new Sentence();
-    for (i = 0; i < sentence->wordCount(); i++){
-        backUp->addWord(new Word(sentence->getWord(i)->getName()));
-    }
-    cfg.removeExceptionalWordsFromSentence(sentence);
-    for (i = 0; i < sentence->wordCount(); i++)
-        for (j = i; j < sentence->wordCount(); j++)
-            table[i][j] = PartialParseList();
-    for (i = 0; i < sentence->wordCount(); i++){
-        candidates = cfg.getTerminalRulesWithRightSideX(Symbol(sentence->getWord(i)->getName()));
+    if (wordCount == 0){
+        return parseTrees;
+    }
+    PARSE_STATISTICS_START(statistics);
+    PARSE_STATISTICS_ADD(statistics, sentenceCount, 1);
+    cfg.normalizeWords(words, wordSymbolIds);
+    PARSE_STATISTICS_PHASE(statistics, normalizationTime);
+    chart.reset(wordCount);
+    for (i = 0; i < wordCount; i++){
+        candidates = cfg.getTerminalRulesWithRightSideX(wordSymbolIds[i]);
+        PARSE_STATISTICS_ADD(statistics, cellsFilled, 1);
+        PARSE_STATISTICS_ADD(statistics, ruleLookups, candidates.size());
+        PARSE_STATISTICS_ADD(statistics, edgesCreated, candidates.size());
+        if (candidates.empty()){
+            continue;
+        }
+        ArenaParseNode* leaf = arena.createParseNode(i);
         for (Rule* candidate: candidates){
-            table[i][i].addPartialParse(new ParseNode(new ParseNode(Symbol(sentence->getWord(i)->getName())), candidate->getLeftHandSide()));
+            chart.get(i, i).addPartialParse(arena.createParseNode(leaf, candidate->getLeftHandSideId()), candidate->getLeftHandSideId());
         }
+        applyUnaryClosure(cfg, i, i, arena, statistics);
     }
-    for (j = 1; j < sentence->wordCount(); j++){
-        for (i = j - 1; i >= 0; i--)
-            for (k = i; k < j; k++){
-                for (x = 0; x < table[i][k].size(); x++)
-                    for (y = 0; y < table[k + 1][j].size(); y++){
-                        leftNode = table[i][k].getPartialParse(x);
-                        rightNode = table[k + 1][j].getPartialParse(y);
-                        candidates = cfg.getRulesWithTwoNonTerminalsOnRightSide(leftNode->getData(), rightNode->getData());
-                        for (Rule* candidate: candidates){
-                            table[i][j].addPartialParse(new ParseNode(leftNode, rightNode, candidate->getLeftHandSide()));
-                        }
-                    }
+    PARSE_STATISTICS_PHASE(statistics, lexicalFillTime);
+    if (pool == nullptr){
+        for (j = 1; j < wordCount; j++){
+            for (i = j - 1; i >= 0; i--){
+                fillCell(cfg, i, j, arena, statistics);
             }
+        }
+    } else {
+        for (int length = 1; length < wordCount; length++){
+            pool->parallelFor(wordCount - length, [&](int start, int worker){
+                fillCell(cfg, start, start + length, *workerArenas[worker], statistics == nullptr ? nullptr : &workerStatistics[worker]);
+            });
+        }
+    }
+#ifdef SYNTACTICPARSER_STATISTICS
+    if (statistics != nullptr){
+        statistics->nodesAllocated += arena.size();
+        for (int worker = 0; worker < workerStatistics.size(); worker++){
+            statistics->add(workerStatistics[worker]);
+            statistics->nodesAllocated += workerArenas[worker]->size();
+            workerStatistics[worker].clear();
+        }
+        statistics->peakChartSize = max(statistics->peakChartSize, (long long) chart.size());
     }
-    for (i = 0; i < table[0][sentence->wordCount() - 1].size(); i++){
-        if (table[0][sentence->wordCount() - 1].getPartialParse(i)->getData().getName() == "S") {
-            auto* parseTree = new ParseTree(table[0][sentence->wordCount() - 1].getPartialParse(i));
+#endif
+    PARSE_STATISTICS_PHASE(statistics, binaryFillTime);
+    const PartialParseList& root = chart.get(0, wordCount - 1);
+    for (i = 0; i < root.size(); i++){
+        if (root.getSymbolId(i) == startSymbolId) {
+            auto* parseTree = new ParseTree(ParseNodeArena::copyTree(root.getPartialParse(i), cfg, words, false));
             parseTree->correctParents();
             parseTree->removeXNodes();
             parseTrees.emplace_back(parseTree);
         }
     }
-    for (ParseTree* parseTree : parseTrees){
-        cfg.reinsertExceptionalWordsFromSentence(parseTree, backUp);
+    PARSE_STATISTICS_PHASE(statistics, treeExtractionTime);
+    arena.reset();
+    for (unique_ptr<ParseNodeArena>& workerArena : workerArenas){
+        workerArena->reset();
     }
     return parseTrees;
-}
\ No newline at end of file
+}
+
+/**
+ * Constructs a packed parse forest of a given sentence according to the given grammar. The words of the sentence are
+ * not changed.
+ * @param cfg Context free grammar used in parsing.
+ * @param sentence Sentence to be parsed.
+ * @return Packed parse forest of the given sentence.
+ */
+ParseForest CYKParser::parseForest(const ContextFreeGrammar& cfg, Sentence* sentence){
+    vector<string> words;
+    for (int i = 0; i < sentence->wordCount(); i++){
+        words.emplace_back(sentence->getWord(i)->getName());
+    }
+    return parseForest(cfg, words);
+}
+
+/**
+ * Constructs a packed parse forest of the given words according to the given grammar. Contrary to parse, every
+ * (span, non-terminal) pair is stored only once together with its alternative derivations, so the forest takes
+ * polynomial time and memory even when the number of parse trees grows exponentially. The trees can then be
+ * counted, sampled or constructed one by one from the forest. The words are only read and are the leaves of the
+ * trees. The forest does not apply unary rules, so the grammar must be in Chomsky normal form without unary rules.
+ * @param cfg Context free grammar used in parsing.
+ * @param words Words of the sentence to be parsed.
+ * @return Packed parse forest of the given words.
+ * @throws invalid_argument if the grammar has unary rules.
+ */
+ParseForest CYKParser::parseForest(const ContextFreeGrammar& cfg, span<const string> words){
+    int i, j, k, x, y, ruleIndex, wordCount = words.size();
+    pair<int, int> range, leftNodes, rightNodes;
+    ParseForest forest;
+    if (cfg.hasUnaryRules()){
+        throw invalid_argument("CYKParser::parseForest needs a grammar in Chomsky normal form without unary rules");
+    }
+    cfg.normalizeWords(words, wordSymbolIds);
+    forest.reset(&cfg, words);
+    for (i = 0; i < wordCount; i++){
+        forest.beginCell(i, i);
+        range = cfg.getTerminalRuleRange(wordSymbolIds[i]);
+        for (x = range.first; x < range.second; x++){
+            forest.addDerivation(cfg.getTerminalRule(x)->getLeftHandSideId(), x, -1, -1, -1);
+        }
+        forest.endCell();
+    }
+    for (j = 1; j < wordCount; j++){
+        for (i = j - 1; i >= 0; i--){
+            forest.beginCell(i, j);
+            for (k = i; k < j; k++){
+                leftNodes = forest.getCellNodes(i, k);
+                rightNodes = forest.getCellNodes(k + 1, j);
+                for (x = leftNodes.first; x < leftNodes.second; x++)
+                    for (y = rightNodes.first; y < rightNodes.second; y++){
+                        range = cfg.getBinaryRuleRange(forest.getNode(x).symbolId, forest.getNode(y).symbolId);
+                        for (ruleIndex = range.first; ruleIndex < range.second; ruleIndex++){
+                            forest.addDerivation(cfg.getBinaryRule(ruleIndex)->getLeftHandSideId(), ruleIndex, k, x, y);
+                        }
+                    }
+            }
+            forest.endCell();
+        }
+    }
+    forest.finish();
+    return forest;
+}
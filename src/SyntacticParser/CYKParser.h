@@ -7,10 +7,30 @@
 
 
 #include "SyntacticParser.h"
+#include "PartialParseChart.h"
+#include "ParseNodeArena.h"
+#include "ParseForest.h"
+#include "WorkStealingPool.h"
+#include "ParseStatistics.h"
 
 class CYKParser : public SyntacticParser{
+private:
+    PartialParseChart chart;
+    ParseNodeArena arena;
+    unique_ptr<WorkStealingPool> pool;
+    vector<unique_ptr<ParseNodeArena>> workerArenas;
+    vector<ParseStatistics> workerStatistics;
+    vector<int> wordSymbolIds;
+    void fillCell(const ContextFreeGrammar& cfg, int i, int j, ParseNodeArena& cellArena, ParseStatistics* cellStatistics);
+    void applyUnaryClosure(const ContextFreeGrammar& cfg, int i, int j, ParseNodeArena& cellArena, ParseStatistics* cellStatistics);
 public:
+    void setThreadCount(int threadCount);
     vector<ParseTree*> parse(const ContextFreeGrammar& cfg, Sentence* sentence);
+    vector<ParseTree*> parse(const ContextFreeGrammar& cfg, span<const string> words);
+    vector<ParseTree*> parse(const ContextFreeGrammar& cfg, Sentence* sentence, ParseStatistics* statistics);
+    vector<ParseTree*> parse(const ContextFreeGrammar& cfg, span<const string> words, ParseStatistics* statistics);
+    ParseForest parseForest(const ContextFreeGrammar& cfg, Sentence* sentence);
+    ParseForest parseForest(const ContextFreeGrammar& cfg, span<const string> words);
 };
 
 
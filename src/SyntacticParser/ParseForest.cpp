@@ -0,0 +1,280 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include "ParseForest.h"
+#include <cmath>
+
+/**
+ * Prepares the forest for a new sentence. Every node of the forest is a pair of a span and a non-terminal symbol,
+ * which appears exactly once, together with the list of its alternative derivations. A derivation is either a
+ * terminal rule, or a binary rule with a split point and the two child nodes.
+ * @param cfg Context free grammar used in parsing.
+ * @param words Words of the sentence, used as the leaves of the trees.
+ */
+void ParseForest::reset(const ContextFreeGrammar* cfg, span<const string> words) {
+    int cellCount = words.size() * (words.size() + 1) / 2;
+    this->cfg = cfg;
+    this->words.assign(words.begin(), words.end());
+    nodes.clear();
+    derivations.clear();
+    treeCounts.clear();
+    cellNodes.assign(cellCount, make_pair(0, 0));
+    currentCellNodes.assign(cfg->getNonTerminalCount(), -1);
+    currentCell = -1;
+    rootNode = -1;
+}
+
+/**
+ * Returns the position of the cell (i, j). Only the cells with i <= j are stored, row by row.
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @return Position of the cell (i, j).
+ */
+int ParseForest::cellIndex(int i, int j) const {
+    return i * (int) words.size() - i * (i - 1) / 2 + (j - i);
+}
+
+/**
+ * Starts filling the cell (i, j). All derivations of the nodes of a cell must be added between beginCell and
+ * endCell, and the cells must be filled bottom up.
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ */
+void ParseForest::beginCell(int i, int j) {
+    currentCell = cellIndex(i, j);
+    currentStart = i;
+    currentEnd = j;
+    cellNodes[currentCell] = make_pair(nodes.size(), nodes.size());
+}
+
+/**
+ * Adds a derivation to the node of the given symbol in the current cell. The node is created when its first
+ * derivation is added.
+ * @param symbolId Id of the non-terminal symbol of the node.
+ * @param ruleIndex Position of the rule in the binary rule index of the grammar, or in the terminal rule index if
+ *                  split is -1.
+ * @param split Split point of the derivation, -1 for a terminal rule.
+ * @param leftNode Left child node, -1 for a terminal rule.
+ * @param rightNode Right child node, -1 for a terminal rule.
+ * @return Index of the node.
+ */
+int ParseForest::addDerivation(int symbolId, int ruleIndex, int split, int leftNode, int rightNode) {
+    int node = currentCellNodes[symbolId];
+    if (node == -1){
+        int start = cellNodes[currentCell].first;
+        node = nodes.size();
+        nodes.push_back({currentStart, currentEnd, symbolId, -1, -1});
+        currentCellNodes[symbolId] = node;
+        cellNodes[currentCell] = make_pair(start, node + 1);
+    }
+    derivations.push_back({ruleIndex, split, leftNode, rightNode, -1});
+    if (nodes[node].lastDerivation == -1){
+        nodes[node].firstDerivation = derivations.size() - 1;
+    } else {
+        derivations[nodes[node].lastDerivation].next = derivations.size() - 1;
+    }
+    nodes[node].lastDerivation = derivations.size() - 1;
+    return node;
+}
+
+/**
+ * Finishes filling the current cell.
+ */
+void ParseForest::endCell() {
+    for (int node = cellNodes[currentCell].first; node < cellNodes[currentCell].second; node++){
+        currentCellNodes[nodes[node].symbolId] = -1;
+    }
+    currentCell = -1;
+}
+
+/**
+ * Finishes the construction of the forest. Counts the trees below every node bottom up and finds the node of the
+ * start symbol S spanning the whole sentence.
+ */
+void ParseForest::finish() {
+    treeCounts.assign(nodes.size(), 0);
+    for (int node = 0; node < nodes.size(); node++){
+        for (int derivation = nodes[node].firstDerivation; derivation != -1; derivation = derivations[derivation].next){
+            treeCounts[node] += derivationCount(derivations[derivation]);
+        }
+    }
+    rootNode = -1;
+    if (!words.empty()){
+        pair<int, int> rootCell = getCellNodes(0, words.size() - 1);
+        for (int node = rootCell.first; node < rootCell.second; node++){
+            if (nodes[node].symbolId == cfg->getStartSymbolId()){
+                rootNode = node;
+            }
+        }
+    }
+}
+
+/**
+ * Returns the number of trees of a derivation, which is the product of the numbers of trees of its children.
+ * @param derivation Derivation of a node.
+ * @return Number of trees of the derivation.
+ */
+double ParseForest::derivationCount(const ForestDerivation& derivation) const {
+    if (derivation.split == -1){
+        return 1;
+    }
+    return treeCounts[derivation.leftNode] * treeCounts[derivation.rightNode];
+}
+
+/**
+ * Returns the range of the nodes of the cell (i, j).
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @return Start (inclusive) and end (exclusive) indexes of the nodes spanning the words from i to j.
+ */
+pair<int, int> ParseForest::getCellNodes(int i, int j) const {
+    return cellNodes[cellIndex(i, j)];
+}
+
+/**
+ * Accessor for the node with the given index.
+ * @param index Index of the node.
+ * @return Node with the given index.
+ */
+const ForestNode& ParseForest::getNode(int index) const {
+    return nodes[index];
+}
+
+/**
+ * Returns number of nodes in the forest.
+ * @return Number of nodes in the forest.
+ */
+int ParseForest::getNodeCount() const {
+    return nodes.size();
+}
+
+/**
+ * Returns number of derivations in the forest.
+ * @return Number of derivations in the forest.
+ */
+int ParseForest::getDerivationCount() const {
+    return derivations.size();
+}
+
+/**
+ * Accessor for the node of the start symbol S spanning the whole sentence.
+ * @return Index of the root node, -1 if the sentence can not be parsed.
+ */
+int ParseForest::getRootNode() const {
+    return rootNode;
+}
+
+/**
+ * Returns number of parse trees in the forest, without constructing them.
+ * @return Number of parse trees of the sentence.
+ */
+double ParseForest::getTreeCount() const {
+    if (rootNode == -1){
+        return 0;
+    }
+    return treeCounts[rootNode];
+}
+
+/**
+ * Constructs the subtree with the given index below the given node. The trees below a node are numbered derivation
+ * by derivation; inside a derivation, the index is split into the indexes of the left and right subtrees.
+ * @param node Index of the node.
+ * @param index Index of the subtree, smaller than the number of trees below the node.
+ * @return Root of the constructed subtree.
+ */
+ParseNode* ParseForest::constructTree(int node, double index) const {
+    for (int derivation = nodes[node].firstDerivation; derivation != -1; derivation = derivations[derivation].next){
+        const ForestDerivation& current = derivations[derivation];
+        double count = derivationCount(current);
+        if (index < count || current.next == -1){
+            if (current.split == -1){
+                return new ParseNode(new ParseNode(Symbol(words[nodes[node].start])), cfg->getSymbol(nodes[node].symbolId));
+            }
+            double rightCount = treeCounts[current.rightNode];
+            double leftIndex = floor(index / rightCount);
+            ParseNode* left = constructTree(current.leftNode, leftIndex);
+            ParseNode* right = constructTree(current.rightNode, index - leftIndex * rightCount);
+            return new ParseNode(left, right, cfg->getSymbol(nodes[node].symbolId));
+        }
+        index -= count;
+    }
+    return nullptr;
+}
+
+/**
+ * Constructs a subtree below the given node, drawn uniformly at random among all subtrees of the node.
+ * @param node Index of the node.
+ * @param generator Random number generator.
+ * @return Root of the constructed subtree.
+ */
+ParseNode* ParseForest::sampleTree(int node, mt19937& generator) const {
+    uniform_real_distribution<double> distribution(0.0, treeCounts[node]);
+    double value = distribution(generator);
+    for (int derivation = nodes[node].firstDerivation; derivation != -1; derivation = derivations[derivation].next){
+        const ForestDerivation& current = derivations[derivation];
+        double count = derivationCount(current);
+        if (value < count || current.next == -1){
+            if (current.split == -1){
+                return new ParseNode(new ParseNode(Symbol(words[nodes[node].start])), cfg->getSymbol(nodes[node].symbolId));
+            }
+            ParseNode* left = sampleTree(current.leftNode, generator);
+            ParseNode* right = sampleTree(current.rightNode, generator);
+            return new ParseNode(left, right, cfg->getSymbol(nodes[node].symbolId));
+        }
+        value -= count;
+    }
+    return nullptr;
+}
+
+/**
+ * Wraps a constructed tree into a parse tree and removes the X nodes introduced by the Chomsky normal form.
+ * @param root Root of the constructed tree.
+ * @return Parse tree.
+ */
+ParseTree* ParseForest::toParseTree(ParseNode* root) const {
+    auto* parseTree = new ParseTree(root);
+    parseTree->correctParents();
+    parseTree->removeXNodes();
+    return parseTree;
+}
+
+/**
+ * Constructs the parse tree with the given index. The trees are numbered from 0 to getTreeCount() - 1; the
+ * numbering is exact as long as the number of trees fits the mantissa of a double.
+ * @param index Index of the tree.
+ * @return Parse tree with the given index, nullptr if the sentence can not be parsed.
+ */
+ParseTree* ParseForest::getTree(double index) const {
+    if (rootNode == -1){
+        return nullptr;
+    }
+    return toParseTree(constructTree(rootNode, index));
+}
+
+/**
+ * Constructs a parse tree drawn uniformly at random among all parse trees of the forest.
+ * @param generator Random number generator.
+ * @return Random parse tree, nullptr if the sentence can not be parsed.
+ */
+ParseTree* ParseForest::sampleTree(mt19937& generator) const {
+    if (rootNode == -1){
+        return nullptr;
+    }
+    return toParseTree(sampleTree(rootNode, generator));
+}
+
+/**
+ * Constructs the parse trees with indexes first, first + 1, ..., first + count - 1. Iterating over the forest in
+ * such batches never materializes more than count trees at once.
+ * @param first Index of the first tree.
+ * @param count Number of trees to construct.
+ * @return Constructed parse trees; fewer than count if the forest runs out of trees.
+ */
+vector<ParseTree*> ParseForest::getTrees(double first, int count) const {
+    vector<ParseTree*> parseTrees;
+    for (double index = first; index < first + count && index < getTreeCount(); index++){
+        parseTrees.emplace_back(getTree(index));
+    }
+    return parseTrees;
+}
@@ -0,0 +1,65 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#ifndef SYNTACTICPARSER_PARSEFOREST_H
+#define SYNTACTICPARSER_PARSEFOREST_H
+
+#include <random>
+#include "ParseTree.h"
+#include "../ContextFreeGrammar/ContextFreeGrammar.h"
+
+struct ForestDerivation {
+    int ruleIndex;
+    int split;
+    int leftNode;
+    int rightNode;
+    int next;
+};
+
+struct ForestNode {
+    int start;
+    int end;
+    int symbolId;
+    int firstDerivation;
+    int lastDerivation;
+};
+
+class ParseForest {
+private:
+    const ContextFreeGrammar* cfg = nullptr;
+    vector<string> words;
+    vector<ForestNode> nodes;
+    vector<ForestDerivation> derivations;
+    vector<double> treeCounts;
+    vector<pair<int, int>> cellNodes;
+    vector<int> currentCellNodes;
+    int currentCell = -1;
+    int currentStart = -1;
+    int currentEnd = -1;
+    int rootNode = -1;
+    [[nodiscard]] int cellIndex(int i, int j) const;
+    [[nodiscard]] double derivationCount(const ForestDerivation& derivation) const;
+    ParseNode* constructTree(int node, double index) const;
+    ParseNode* sampleTree(int node, mt19937& generator) const;
+    ParseTree* toParseTree(ParseNode* root) const;
+public:
+    ParseForest() = default;
+    void reset(const ContextFreeGrammar* cfg, span<const string> words);
+    void beginCell(int i, int j);
+    int addDerivation(int symbolId, int ruleIndex, int split, int leftNode, int rightNode);
+    void endCell();
+    void finish();
+    [[nodiscard]] pair<int, int> getCellNodes(int i, int j) const;
+    [[nodiscard]] const ForestNode& getNode(int index) const;
+    [[nodiscard]] int getNodeCount() const;
+    [[nodiscard]] int getDerivationCount() const;
+    [[nodiscard]] int getRootNode() const;
+    [[nodiscard]] double getTreeCount() const;
+    [[nodiscard]] ParseTree* getTree(double index) const;
+    [[nodiscard]] ParseTree* sampleTree(mt19937& generator) const;
+    [[nodiscard]] vector<ParseTree*> getTrees(double first, int count) const;
+};
+
+
+#endif //SYNTACTICPARSER_PARSEFOREST_H
@@ -0,0 +1,134 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include "ParseNodeArena.h"
+#include "../ContextFreeGrammar/ContextFreeGrammar.h"
+
+/**
+ * Constructor for the ParseNodeArena class. The arena allocates the nodes of a single parse from a monotonic buffer,
+ * which is released at once when the parse is finished.
+ */
+ParseNodeArena::ParseNodeArena() {
+    resource = make_unique<pmr::monotonic_buffer_resource>();
+}
+
+/**
+ * Allocates a node from the monotonic buffer.
+ * @param left Left child of the node, null for a leaf.
+ * @param right Right child of the node, null for a leaf or a node with a single child.
+ * @param label Grammar id of the symbol of the node, or the position of the word of a leaf.
+ * @param logProbability Logarithm of the probability of the node.
+ * @return New node owned by the arena.
+ */
+ArenaParseNode* ParseNodeArena::allocate(ArenaParseNode* left, ArenaParseNode* right, int label, double logProbability) {
+    nodeCount++;
+    return new (resource->allocate(sizeof(ArenaParseNode), alignof(ArenaParseNode))) ArenaParseNode{left, right, label, logProbability};
+}
+
+/**
+ * Creates a parse node with two children in the arena.
+ * @param left Left child of the node.
+ * @param right Right child of the node.
+ * @param symbolId Grammar id of the symbol of the node.
+ * @return New parse node owned by the arena.
+ */
+ArenaParseNode* ParseNodeArena::createParseNode(ArenaParseNode* left, ArenaParseNode* right, int symbolId) {
+    return allocate(left, right, symbolId, 0.0);
+}
+
+/**
+ * Creates a parse node with a single child in the arena.
+ * @param left Child of the node.
+ * @param symbolId Grammar id of the symbol of the node.
+ * @return New parse node owned by the arena.
+ */
+ArenaParseNode* ParseNodeArena::createParseNode(ArenaParseNode* left, int symbolId) {
+    return allocate(left, nullptr, symbolId, 0.0);
+}
+
+/**
+ * Creates a leaf parse node in the arena.
+ * @param wordIndex Position of the word of the leaf in the sentence.
+ * @return New parse node owned by the arena.
+ */
+ArenaParseNode* ParseNodeArena::createParseNode(int wordIndex) {
+    return allocate(nullptr, nullptr, wordIndex, 0.0);
+}
+
+/**
+ * Creates a probabilistic parse node with two children in the arena.
+ * @param left Left child of the node.
+ * @param right Right child of the node.
+ * @param symbolId Grammar id of the symbol of the node.
+ * @param logProbability Logarithm of the probability of the node.
+ * @return New probabilistic parse node owned by the arena.
+ */
+ArenaParseNode* ParseNodeArena::createProbabilisticParseNode(ArenaParseNode* left, ArenaParseNode* right, int symbolId, double logProbability) {
+    return allocate(left, right, symbolId, logProbability);
+}
+
+/**
+ * Creates a probabilistic parse node with a single child in the arena.
+ * @param left Child of the node.
+ * @param symbolId Grammar id of the symbol of the node.
+ * @param logProbability Logarithm of the probability of the node.
+ * @return New probabilistic parse node owned by the arena.
+ */
+ArenaParseNode* ParseNodeArena::createProbabilisticParseNode(ArenaParseNode* left, int symbolId, double logProbability) {
+    return allocate(left, nullptr, symbolId, logProbability);
+}
+
+/**
+ * Copies the subtree rooted at the given chart node out of the arena. The copy is allocated on the heap, does not
+ * share any node with the chart, and therefore survives the reset of the arena. The symbols of the nodes are read
+ * from the grammar, and the leaves are the words of the sentence.
+ * @param parseNode Root of the subtree to be copied.
+ * @param cfg Grammar whose symbol ids label the nodes.
+ * @param words Words of the sentence whose positions label the leaves.
+ * @param probabilistic If true, the non-leaf nodes of the copy are ProbabilisticParseNodes with the log probabilities
+ *                      of the chart nodes.
+ * @return Root of the copied subtree.
+ */
+ParseNode* ParseNodeArena::copyTree(const ArenaParseNode* parseNode, const ContextFreeGrammar& cfg, span<const string> words, bool probabilistic) {
+    if (parseNode->left == nullptr){
+        return new ParseNode(Symbol(words[parseNode->label]));
+    }
+    const Symbol& data = cfg.getSymbol(parseNode->label);
+    ParseNode* left = copyTree(parseNode->left, cfg, words, probabilistic);
+    if (parseNode->right == nullptr){
+        if (probabilistic){
+            return new ProbabilisticParseNode(left, data, parseNode->logProbability);
+        }
+        return new ParseNode(left, data);
+    }
+    ParseNode* right = copyTree(parseNode->right, cfg, words, probabilistic);
+    if (probabilistic){
+        return new ProbabilisticParseNode(left, right, data, parseNode->logProbability);
+    }
+    return new ParseNode(left, right, data);
+}
+
+/**
+ * Releases the memory of all nodes of the arena at once; the nodes have no destructors to run. The buffer grows to
+ * the peak size of the previous parses, so that parses of similar size do not allocate from the heap again.
+ */
+void ParseNodeArena::reset() {
+    size_t allocatedBytes = nodeCount * sizeof(ArenaParseNode);
+    if (allocatedBytes > buffer.size()){
+        resource.reset();
+        buffer.resize(2 * allocatedBytes);
+        resource = make_unique<pmr::monotonic_buffer_resource>(buffer.data(), buffer.size());
+    } else {
+        resource->release();
+    }
+    nodeCount = 0;
+}
+
+/**
+ * Returns number of nodes in the arena.
+ * @return Number of nodes in the arena.
+ */
+int ParseNodeArena::size() const {
+    return nodeCount;
+}
@@ -0,0 +1,50 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#ifndef SYNTACTICPARSER_PARSENODEARENA_H
+#define SYNTACTICPARSER_PARSENODEARENA_H
+
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <ParseNode.h>
+#include "../ProbabilisticContextFreeGrammar/ProbabilisticParseNode.h"
+
+class ContextFreeGrammar;
+
+/**
+ * Node of a partial parse in the chart, allocated from a ParseNodeArena. The node has fixed slots for at most two
+ * children, which are shared with other partial parses, and its label is the grammar id of its symbol, or the position
+ * of its word if it is a leaf. Therefore the node owns no memory and needs no destructor; it is converted into a
+ * ParseNode only when a parse tree is copied out of the chart.
+ */
+struct ArenaParseNode {
+    ArenaParseNode* left;
+    ArenaParseNode* right;
+    int label;
+    double logProbability;
+};
+
+class ParseNodeArena {
+private:
+    vector<char> buffer;
+    unique_ptr<pmr::monotonic_buffer_resource> resource;
+    int nodeCount = 0;
+    ArenaParseNode* allocate(ArenaParseNode* left, ArenaParseNode* right, int label, double logProbability);
+public:
+    ParseNodeArena();
+    ParseNodeArena(const ParseNodeArena&) = delete;
+    ParseNodeArena& operator=(const ParseNodeArena&) = delete;
+    ArenaParseNode* createParseNode(ArenaParseNode* left, ArenaParseNode* right, int symbolId);
+    ArenaParseNode* createParseNode(ArenaParseNode* left, int symbolId);
+    ArenaParseNode* createParseNode(int wordIndex);
+    ArenaParseNode* createProbabilisticParseNode(ArenaParseNode* left, ArenaParseNode* right, int symbolId, double logProbability);
+    ArenaParseNode* createProbabilisticParseNode(ArenaParseNode* left, int symbolId, double logProbability);
+    static ParseNode* copyTree(const ArenaParseNode* parseNode, const ContextFreeGrammar& cfg, span<const string> words, bool probabilistic);
+    void reset();
+    [[nodiscard]] int size() const;
+};
+
+
+#endif //SYNTACTICPARSER_PARSENODEARENA_H
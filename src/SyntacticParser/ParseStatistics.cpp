@@ -0,0 +1,84 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include "ParseStatistics.h"
+
+/**
+ * Adds the counters and phase times of the given statistics to these statistics. The peak chart size becomes the
+ * larger of the two.
+ * @param statistics Statistics to be added, such as the statistics of one worker of a batch.
+ */
+void ParseStatistics::add(const ParseStatistics& statistics){
+    sentenceCount += statistics.sentenceCount;
+    cellsFilled += statistics.cellsFilled;
+    childPairs += statistics.childPairs;
+    ruleLookups += statistics.ruleLookups;
+    edgesCreated += statistics.edgesCreated;
+    edgesReplaced += statistics.edgesReplaced;
+    nodesAllocated += statistics.nodesAllocated;
+    peakChartSize = max(peakChartSize, statistics.peakChartSize);
+    normalizationTime += statistics.normalizationTime;
+    lexicalFillTime += statistics.lexicalFillTime;
+    binaryFillTime += statistics.binaryFillTime;
+    treeExtractionTime += statistics.treeExtractionTime;
+}
+
+/**
+ * Sets all counters and phase times to zero.
+ */
+void ParseStatistics::clear(){
+    *this = ParseStatistics();
+}
+
+/**
+ * Returns the statistics as metric names and values, in the order of the fields, to be exported to a metrics system.
+ * The phase times are in seconds.
+ * @return Pairs of metric names and values.
+ */
+vector<pair<string, double>> ParseStatistics::getMetrics() const{
+    return {{"sentences", (double) sentenceCount},
+            {"cells_filled", (double) cellsFilled},
+            {"child_pairs", (double) childPairs},
+            {"rule_lookups", (double) ruleLookups},
+            {"edges_created", (double) edgesCreated},
+            {"edges_replaced", (double) edgesReplaced},
+            {"nodes_allocated", (double) nodesAllocated},
+            {"peak_chart_size", (double) peakChartSize},
+            {"normalization_seconds", normalizationTime},
+            {"lexical_fill_seconds", lexicalFillTime},
+            {"binary_fill_seconds", binaryFillTime},
+            {"tree_extraction_seconds", treeExtractionTime}};
+}
+
+/**
+ * Counts the result of offering a partial parse to a cell of a probabilistic chart as a created or a replaced edge.
+ * @param statistics Statistics to be updated, nothing is counted if it is null.
+ * @param update Result of PartialParseList::updatePartialParse.
+ */
+void ParseStatistics::countUpdate(ParseStatistics* statistics, PartialParseUpdate update){
+    if (statistics != nullptr){
+        if (update == PartialParseUpdate::ADDED){
+            statistics->edgesCreated++;
+        } else {
+            if (update == PartialParseUpdate::REPLACED){
+                statistics->edgesReplaced++;
+            }
+        }
+    }
+}
+
+/**
+ * Ends a phase of parsing: adds the wall time since the given start to the time of the phase, and starts the next
+ * phase now.
+ * @param statistics Statistics to be updated, nothing is measured if it is null.
+ * @param phase Time of the phase in the statistics.
+ * @param start Start of the phase, set to the start of the next phase.
+ */
+void ParseStatistics::lap(ParseStatistics* statistics, double ParseStatistics::*phase, chrono::steady_clock::time_point& start){
+    if (statistics != nullptr){
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        statistics->*phase += chrono::duration<double>(now - start).count();
+        start = now;
+    }
+}
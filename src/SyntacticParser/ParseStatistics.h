@@ -0,0 +1,59 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#ifndef SYNTACTICPARSER_PARSESTATISTICS_H
+#define SYNTACTICPARSER_PARSESTATISTICS_H
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "PartialParseList.h"
+
+using namespace std;
+
+/**
+ * Counters and phase timers of the CYK parsers, filled when a ParseStatistics is passed to their parse methods. The
+ * counters are added up over all sentences parsed with the same statistics, except the peak chart size, which is the
+ * maximum, so one object can aggregate a whole batch. The parsers update the statistics only if the library is built
+ * with SYNTACTICPARSER_STATISTICS defined; otherwise the macros below compile to nothing and the statistics stay zero.
+ * Child pairs are the pairs of partial parses of two adjacent cells combined, rule lookups the candidate rules the
+ * grammar returned for words, child pairs and unary chains, edges the partial parses added to a cell or replacing a
+ * less probable one, nodes the parse nodes allocated from the arenas, and the chart size the number of partial
+ * parses in the chart after it is filled. The phase times are wall times in seconds.
+ */
+struct ParseStatistics {
+    long long sentenceCount = 0;
+    long long cellsFilled = 0;
+    long long childPairs = 0;
+    long long ruleLookups = 0;
+    long long edgesCreated = 0;
+    long long edgesReplaced = 0;
+    long long nodesAllocated = 0;
+    long long peakChartSize = 0;
+    double normalizationTime = 0.0;
+    double lexicalFillTime = 0.0;
+    double binaryFillTime = 0.0;
+    double treeExtractionTime = 0.0;
+    void add(const ParseStatistics& statistics);
+    void clear();
+    [[nodiscard]] vector<pair<string, double>> getMetrics() const;
+    static void countUpdate(ParseStatistics* statistics, PartialParseUpdate update);
+    static void lap(ParseStatistics* statistics, double ParseStatistics::*phase, chrono::steady_clock::time_point& start);
+};
+
+#ifdef SYNTACTICPARSER_STATISTICS
+#define PARSE_STATISTICS_ADD(statistics, counter, value) do { if ((statistics) != nullptr) (statistics)->counter += (value); } while (false)
+#define PARSE_STATISTICS_UPDATE(statistics, update) ParseStatistics::countUpdate(statistics, update)
+#define PARSE_STATISTICS_START(statistics) chrono::steady_clock::time_point parseStatisticsLap = (statistics) != nullptr ? chrono::steady_clock::now() : chrono::steady_clock::time_point()
+#define PARSE_STATISTICS_PHASE(statistics, phase) ParseStatistics::lap(statistics, &ParseStatistics::phase, parseStatisticsLap)
+#else
+#define PARSE_STATISTICS_ADD(statistics, counter, value) do { } while (false)
+#define PARSE_STATISTICS_UPDATE(statistics, update) (update)
+#define PARSE_STATISTICS_START(statistics) do { } while (false)
+#define PARSE_STATISTICS_PHASE(statistics, phase) do { } while (false)
+#endif
+
+
+#endif //SYNTACTICPARSER_PARSESTATISTICS_H
@@ -0,0 +1,73 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include "PartialParseChart.h"
+
+/**
+ * Prepares the chart for a new sentence. The chart stores only the cells (i, j) with i <= j, contiguously on the
+ * heap. The cells of the previous sentence are emptied but keep their capacity, new cells are constructed only when
+ * the sentence is longer than all previous sentences.
+ * @param wordCount Number of words in the sentence.
+ */
+void PartialParseChart::reset(int wordCount) {
+    int cellCount = wordCount * (wordCount + 1) / 2;
+    int usedCellCount = this->wordCount * (this->wordCount + 1) / 2;
+    for (int cell = 0; cell < usedCellCount; cell++){
+        cells[cell].clear();
+    }
+    if (cellCount > cells.size()){
+        cells.resize(cellCount);
+    }
+    this->wordCount = wordCount;
+}
+
+/**
+ * Returns the position of the cell (i, j) in the chart. Only the cells with i <= j are stored, row by row.
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @return Position of the cell (i, j).
+ */
+int PartialParseChart::cellIndex(int i, int j) const {
+    return i * wordCount - i * (i - 1) / 2 + (j - i);
+}
+
+/**
+ * Accessor for the cell (i, j) of the chart, that is the partial parses spanning the words from i to j.
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @return Partial parses spanning the words from i to j.
+ */
+PartialParseList& PartialParseChart::get(int i, int j) {
+    return cells[cellIndex(i, j)];
+}
+
+/**
+ * Accessor for the cell (i, j) of the chart, that is the partial parses spanning the words from i to j.
+ * @param i Start position of the span.
+ * @param j End position of the span.
+ * @return Partial parses spanning the words from i to j.
+ */
+const PartialParseList& PartialParseChart::get(int i, int j) const {
+    return cells[cellIndex(i, j)];
+}
+
+/**
+ * Accessor for the number of words of the sentence the chart is prepared for.
+ * @return Number of words.
+ */
+int PartialParseChart::getWordCount() const {
+    return wordCount;
+}
+
+/**
+ * Returns the number of partial parses in all cells of the chart.
+ * @return Number of partial parses in the chart.
+ */
+int PartialParseChart::size() const {
+    int result = 0;
+    for (int cell = 0; cell < wordCount * (wordCount + 1) / 2; cell++){
+        result += cells[cell].size();
+    }
+    return result;
+}
@@ -0,0 +1,26 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#ifndef SYNTACTICPARSER_PARTIALPARSECHART_H
+#define SYNTACTICPARSER_PARTIALPARSECHART_H
+
+
+#include "PartialParseList.h"
+
+class PartialParseChart {
+private:
+    int wordCount = 0;
+    vector<PartialParseList> cells;
+public:
+    PartialParseChart() = default;
+    void reset(int wordCount);
+    [[nodiscard]] int cellIndex(int i, int j) const;
+    PartialParseList& get(int i, int j);
+    [[nodiscard]] const PartialParseList& get(int i, int j) const;
+    [[nodiscard]] int getWordCount() const;
+    [[nodiscard]] int size() const;
+};
+
+
+#endif //SYNTACTICPARSER_PARTIALPARSECHART_H
@@ -3,35 +3,85 @@
 //
 
 #include "PartialParseList.h"
+#include <algorithm>
+#include <limits>
 
 /**
  * Adds a new partial parse (actually a parse node representing the root of the subtree of the partial parse)
  * @param parseNode Root of the subtree showing the partial parse.
+ * @param symbolId Grammar id of the symbol of the root node.
  */
-void PartialParseList::addPartialParse(ParseNode* parseNode){
+void PartialParseList::addPartialParse(ArenaParseNode* parseNode, int symbolId){
     partialParses.emplace_back(parseNode);
+    symbolIds.emplace_back(symbolId);
 }
 
 /**
  * Updates the partial parse by removing less probable nodes with the given parse node.
  * @param parseNode Parse node to be added to the partial parse.
+ * @param symbolId Grammar id of the symbol of the parse node.
+ * @return ADDED if the list had no partial parse of the symbol, REPLACED if the given parse node replaced a less
+ * probable one, REJECTED if the list already has a partial parse of the symbol which is at least as probable.
  */
-void PartialParseList::updatePartialParse(ProbabilisticParseNode* parseNode){
-    bool found = false;
+PartialParseUpdate PartialParseList::updatePartialParse(ArenaParseNode* parseNode, int symbolId){
     for (int i = 0; i < partialParses.size(); i++){
-        ParseNode* partialParse = partialParses[i];
-        if (partialParse->getData().getName() == parseNode->getData().getName()){
-            if (((ProbabilisticParseNode *) partialParse)->getLogProbability() < parseNode->getLogProbability()){
+        if (symbolIds[i] == symbolId){
+            if (partialParses[i]->logProbability < parseNode->logProbability){
                 partialParses.erase(partialParses.begin() + i);
+                symbolIds.erase(symbolIds.begin() + i);
                 partialParses.emplace_back(parseNode);
+                symbolIds.emplace_back(symbolId);
+                return PartialParseUpdate::REPLACED;
             }
-            found = true;
-            break;
+            return PartialParseUpdate::REJECTED;
         }
     }
-    if (!found){
-        partialParses.emplace_back(parseNode);
+    partialParses.emplace_back(parseNode);
+    symbolIds.emplace_back(symbolId);
+    return PartialParseUpdate::ADDED;
+}
+
+/**
+ * Removes the improbable partial parses of a completed cell. The figure of merit of a partial parse is its log
+ * probability, plus the outside estimate of its symbol if the estimates are given. The partial parses whose figure of
+ * merit is more than threshold below the best one are removed, and of the remaining ones only the best beamWidth are
+ * kept. The order of the surviving partial parses does not change.
+ * @param beamWidth Maximum number of partial parses kept, 0 or less for no limit.
+ * @param threshold Maximum distance in log probability to the best partial parse.
+ * @param outsideEstimates Outside estimates of the symbols indexed by their ids, empty to use only the log
+ *                         probabilities.
+ */
+void PartialParseList::prune(int beamWidth, double threshold, const vector<double>& outsideEstimates){
+    vector<double> figureOfMerits;
+    double best = -numeric_limits<double>::infinity(), cutoff;
+    int i, kept = 0, tied;
+    for (i = 0; i < partialParses.size(); i++){
+        double figureOfMerit = partialParses[i]->logProbability;
+        if (!outsideEstimates.empty()){
+            figureOfMerit += outsideEstimates[symbolIds[i]];
+        }
+        figureOfMerits.emplace_back(figureOfMerit);
+        best = max(best, figureOfMerit);
+    }
+    cutoff = best - threshold;
+    tied = partialParses.size();
+    if (beamWidth > 0 && beamWidth < partialParses.size()){
+        vector<double> sorted = figureOfMerits;
+        nth_element(sorted.begin(), sorted.begin() + beamWidth - 1, sorted.end(), greater<>());
+        if (sorted[beamWidth - 1] >= cutoff){
+            cutoff = sorted[beamWidth - 1];
+            tied = beamWidth - count_if(sorted.begin(), sorted.end(), [cutoff](double value){ return value > cutoff; });
+        }
+    }
+    for (i = 0; i < partialParses.size(); i++){
+        if (figureOfMerits[i] > cutoff || (figureOfMerits[i] == cutoff && tied-- > 0)){
+            partialParses[kept] = partialParses[i];
+            symbolIds[kept] = symbolIds[i];
+            kept++;
+        }
     }
+    partialParses.resize(kept);
+    symbolIds.resize(kept);
 }
 
 /**
@@ -39,10 +89,19 @@ void PartialParseList::updatePartialParse(ProbabilisticParseNode* parseNode){
  * @param index Position of the parse node.
  * @return Parse node at the given position.
  */
-ParseNode* PartialParseList::getPartialParse(int index) const {
+ArenaParseNode* PartialParseList::getPartialParse(int index) const {
     return partialParses[index];
 }
 
+/**
+ * Returns the grammar id of the symbol of the parse node at the given position.
+ * @param index Position of the parse node.
+ * @return Id of the symbol of the parse node at the given position.
+ */
+int PartialParseList::getSymbolId(int index) const {
+    return symbolIds[index];
+}
+
 /**
  * Returns size of the partial parse.
  * @return Size of the partial parse.
@@ -50,3 +109,11 @@ ParseNode* PartialParseList::getPartialParse(int index) const {
 int PartialParseList::size() const {
     return partialParses.size();
 }
+
+/**
+ * Removes all partial parses, keeping the allocated capacity for reuse.
+ */
+void PartialParseList::clear() {
+    partialParses.clear();
+    symbolIds.clear();
+}
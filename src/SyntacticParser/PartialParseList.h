@@ -6,18 +6,25 @@
 #define SYNTACTICPARSER_PARTIALPARSELIST_H
 
 
-#include <ParseNode.h>
-#include "../ProbabilisticContextFreeGrammar/ProbabilisticParseNode.h"
+#include "ParseNodeArena.h"
+
+enum class PartialParseUpdate{
+    ADDED, REPLACED, REJECTED
+};
 
 class PartialParseList {
 private:
-    vector<ParseNode*> partialParses;
+    vector<ArenaParseNode*> partialParses;
+    vector<int> symbolIds;
 public:
     PartialParseList() = default;
-    void addPartialParse(ParseNode* parseNode);
-    void updatePartialParse(ProbabilisticParseNode* parseNode);
-    [[nodiscard]] ParseNode* getPartialParse(int index) const;
+    void addPartialParse(ArenaParseNode* parseNode, int symbolId);
+    PartialParseUpdate updatePartialParse(ArenaParseNode* parseNode, int symbolId);
+    void prune(int beamWidth, double threshold, const vector<double>& outsideEstimates);
+    [[nodiscard]] ArenaParseNode* getPartialParse(int index) const;
+    [[nodiscard]] int getSymbolId(int index) const;
     [[nodiscard]] int size() const;
+    void clear();
 };
 
 
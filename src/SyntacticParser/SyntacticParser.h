@@ -10,7 +10,8 @@
 
 class SyntacticParser {
 public:
-    virtual vector<ParseTree*> parse(const ContextFreeGrammar& cfg, Sentence* sentence);
+    virtual ~SyntacticParser() = default;
+    virtual vector<ParseTree*> parse(const ContextFreeGrammar& cfg, Sentence* sentence) = 0;
 };
 
 
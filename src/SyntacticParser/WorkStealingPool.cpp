@@ -0,0 +1,146 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include "WorkStealingPool.h"
+
+/**
+ * Constructor for the pool. The worker threads are started once and live as long as the pool; every worker owns a
+ * queue of task indexes and steals from the other queues when its own queue is empty.
+ * @param threadCount Number of worker threads. If it is not positive, the number of hardware threads is used.
+ */
+WorkStealingPool::WorkStealingPool(int threadCount) {
+    if (threadCount <= 0){
+        threadCount = max(1, (int) thread::hardware_concurrency());
+    }
+    for (int i = 0; i < threadCount; i++){
+        queues.emplace_back(make_unique<WorkerQueue>());
+    }
+    for (int i = 0; i < threadCount; i++){
+        threads.emplace_back(&WorkStealingPool::run, this, i);
+    }
+}
+
+/**
+ * Stops the worker threads and waits for them to finish.
+ */
+WorkStealingPool::~WorkStealingPool() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (thread& worker : threads){
+        worker.join();
+    }
+}
+
+/**
+ * Returns number of worker threads.
+ * @return Number of worker threads.
+ */
+int WorkStealingPool::getThreadCount() const {
+    return threads.size();
+}
+
+/**
+ * Takes the next task for the given worker: the front of its own queue, or the back of the queue of another worker.
+ * @param worker Index of the worker.
+ * @param index Output; index of the task taken.
+ * @return True, if a task is taken; false, if all queues are empty.
+ */
+bool WorkStealingPool::nextTask(int worker, int& index) {
+    for (int i = 0; i < queues.size(); i++){
+        WorkerQueue& queue = *queues[(worker + i) % queues.size()];
+        lock_guard<mutex> guard(queue.lock);
+        if (!queue.tasks.empty()){
+            if (i == 0){
+                index = queue.tasks.front();
+                queue.tasks.pop_front();
+            } else {
+                index = queue.tasks.back();
+                queue.tasks.pop_back();
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Main loop of a worker thread. The worker sleeps until a new parallelFor starts, runs tasks until all queues are
+ * empty, and sleeps again.
+ * @param worker Index of the worker.
+ */
+void WorkStealingPool::run(int worker) {
+    long long seen = 0;
+    while (true){
+        const function<void(int, int)>* body;
+        {
+            unique_lock<mutex> guard(lock);
+            workAvailable.wait(guard, [&]{ return stopping || generation != seen; });
+            if (stopping){
+                return;
+            }
+            seen = generation;
+            body = task;
+            busyWorkers++;
+        }
+        int index, done = 0;
+        while (nextTask(worker, index)){
+            try {
+                (*body)(index, worker);
+            } catch (...) {
+                lock_guard<mutex> guard(lock);
+                if (!error){
+                    error = current_exception();
+                }
+            }
+            done++;
+        }
+        {
+            lock_guard<mutex> guard(lock);
+            remaining -= done;
+            busyWorkers--;
+            if (busyWorkers == 0){
+                workFinished.notify_all();
+            }
+        }
+    }
+}
+
+/**
+ * Runs body(index, worker) for every index from 0 to count - 1 on the worker threads and waits until all of them
+ * finish. The indexes are dealt to the worker queues in contiguous blocks, so a worker which finishes its block
+ * early steals from the others. The worker index passed to the body is between 0 and getThreadCount() - 1 and no
+ * two tasks with the same worker index run at the same time, so the body can use per-worker state safely. The
+ * body must not call parallelFor of the same pool.
+ * @param count Number of tasks.
+ * @param body Task to run for every index.
+ */
+void WorkStealingPool::parallelFor(int count, const function<void(int, int)>& body) {
+    if (count <= 0){
+        return;
+    }
+    int workerCount = queues.size();
+    unique_lock<mutex> guard(lock);
+    workFinished.wait(guard, [&]{ return busyWorkers == 0; });
+    for (int i = 0; i < workerCount; i++){
+        lock_guard<mutex> queueGuard(queues[i]->lock);
+        for (int index = (int) ((long long) count * i / workerCount); index < (long long) count * (i + 1) / workerCount; index++){
+            queues[i]->tasks.push_back(index);
+        }
+    }
+    task = &body;
+    remaining = count;
+    error = nullptr;
+    generation++;
+    workAvailable.notify_all();
+    workFinished.wait(guard, [&]{ return remaining == 0 && busyWorkers == 0; });
+    task = nullptr;
+    if (error){
+        exception_ptr thrown = error;
+        error = nullptr;
+        rethrow_exception(thrown);
+    }
+}
@@ -0,0 +1,49 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#ifndef SYNTACTICPARSER_WORKSTEALINGPOOL_H
+#define SYNTACTICPARSER_WORKSTEALINGPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+struct WorkerQueue {
+    mutex lock;
+    deque<int> tasks;
+};
+
+class WorkStealingPool {
+private:
+    vector<thread> threads;
+    vector<unique_ptr<WorkerQueue>> queues;
+    mutex lock;
+    condition_variable workAvailable;
+    condition_variable workFinished;
+    const function<void(int, int)>* task = nullptr;
+    long long generation = 0;
+    int remaining = 0;
+    int busyWorkers = 0;
+    bool stopping = false;
+    exception_ptr error;
+    bool nextTask(int worker, int& index);
+    void run(int worker);
+public:
+    explicit WorkStealingPool(int threadCount);
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+    [[nodiscard]] int getThreadCount() const;
+    void parallelFor(int count, const function<void(int, int)>& body);
+};
+
+
+#endif //SYNTACTICPARSER_WORKSTEALINGPOOL_H
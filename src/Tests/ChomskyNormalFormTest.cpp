@@ -0,0 +1,353 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include "../Benchmarks/GrammarGenerator.h"
+#include "../ContextFreeGrammar/ContextFreeGrammar.h"
+#include "../ProbabilisticContextFreeGrammar/ProbabilisticContextFreeGrammar.h"
+
+/**
+ * Grammar with the conversion to Chomsky normal form as it was before the rules were kept as runs: unary removal
+ * rescans the rules list for the first rule X -> Y, and moves rules with addRule and removeRule in the sorted lists;
+ * binarization rescans the rules list for the first long rule, and rewrites every long rule. It is the reference the
+ * conversion of the grammar is compared with. The reference is not the original code: it is built on addRule,
+ * removeRule and searchRuleIndex of the current grammar, which the conversion shares, and addRule searches the whole
+ * rule since treebank induction deduplicates full rules. A bug in these primitives shows up on both sides of the
+ * comparison, so the conversions of the shipped grammars are also checked against the expected rule files in the
+ * data directory.
+ */
+template <class Grammar>
+class ReferenceGrammar : public Grammar {
+private:
+    [[nodiscard]] Symbol singleNonTerminalCandidate(const vector<Symbol>& removedList) const;
+    [[nodiscard]] Rule* multipleNonTerminalCandidate() const;
+    void addNewRule(Rule* newRule);
+public:
+    using Grammar::Grammar;
+    void convertToChomskyNormalFormReference();
+    [[nodiscard]] const vector<Rule*>& getRules() const;
+    [[nodiscard]] double getProbability(const Rule* rule) const;
+};
+
+/**
+ * Returns the symbol Y of the first rule X -> Y in the rules list, where Y is not in the given list.
+ * @param removedList Symbols whose unary rules are already removed.
+ * @return Symbol Y, a symbol with an empty name if there is no such rule.
+ */
+template <class Grammar>
+Symbol ReferenceGrammar<Grammar>::singleNonTerminalCandidate(const vector<Symbol>& removedList) const{
+    for (const Rule* rule : this->rules){
+        if (rule->getRuleType() == RuleType::SINGLE_NON_TERMINAL && !rule->leftRecursive() && ranges::find(removedList, rule->getRightHandSideAt(0)) == removedList.end()){
+            return rule->getRightHandSideAt(0);
+        }
+    }
+    return Symbol("");
+}
+
+/**
+ * Returns the first rule with more than two symbols on the right hand side in the rules list.
+ * @return First such rule, null if there is no such rule.
+ */
+template <class Grammar>
+Rule* ReferenceGrammar<Grammar>::multipleNonTerminalCandidate() const{
+    for (Rule* rule : this->rules){
+        if (rule->getRuleType() == RuleType::MULTIPLE_NON_TERMINAL){
+            return rule;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Adds a new rule with addRule, deleting it if the grammar already contains an equal rule.
+ * @param newRule Rule to be added.
+ */
+template <class Grammar>
+void ReferenceGrammar<Grammar>::addNewRule(Rule* newRule){
+    if (this->searchRuleIndex(newRule) < 0){
+        this->addRule(newRule);
+    } else {
+        delete newRule;
+    }
+}
+
+/**
+ * Converts the grammar into Chomsky normal form with the previous algorithm, including the fix of the pair being
+ * copied before the long rules are rewritten, and sorts the rules as convertToChomskyNormalForm does.
+ */
+template <class Grammar>
+void ReferenceGrammar<Grammar>::convertToChomskyNormalFormReference(){
+    vector<Symbol> removedList;
+    Symbol removeCandidate = singleNonTerminalCandidate(removedList);
+    while (!removeCandidate.getName().empty()){
+        for (Rule* rule : this->getRulesWithRightSideX(removeCandidate)){
+            for (const Rule* candidate : this->getRulesWithLeftSideX(removeCandidate)){
+                addNewRule(this->createRule(rule->getLeftHandSide(), candidate->getRightHandSide(), candidate->getRuleType(), this->ruleProbability(rule) * this->ruleProbability(candidate)));
+            }
+            this->removeRule(rule);
+            delete rule;
+        }
+        removedList.emplace_back(removeCandidate);
+        removeCandidate = singleNonTerminalCandidate(removedList);
+    }
+    int newVariableCount = 0;
+    Rule* updateCandidate = multipleNonTerminalCandidate();
+    while (updateCandidate != nullptr){
+        Symbol first = updateCandidate->getRightHandSideAt(0);
+        Symbol second = updateCandidate->getRightHandSideAt(1);
+        Symbol newSymbol = Symbol("X" + to_string(newVariableCount));
+        for (Rule* rule : this->rules){
+            if (rule->getRuleType() == RuleType::MULTIPLE_NON_TERMINAL){
+                rule->updateMultipleNonTerminal(first, second, newSymbol);
+            }
+        }
+        addNewRule(this->createRule(newSymbol, {first, second}, RuleType::TWO_NON_TERMINAL, 1.0));
+        updateCandidate = multipleNonTerminalCandidate();
+        newVariableCount++;
+    }
+    this->setRules(this->rules);
+    this->updateSymbolIds();
+    this->updateRuleIndex();
+}
+
+/**
+ * Accessor for the rules list.
+ * @return Rules sorted on their left hand sides.
+ */
+template <class Grammar>
+const vector<Rule*>& ReferenceGrammar<Grammar>::getRules() const{
+    return this->rules;
+}
+
+/**
+ * Returns the probability of a rule, 0 for the rules of a non-probabilistic grammar.
+ * @param rule Rule of the grammar.
+ * @return Probability of the rule.
+ */
+template <class Grammar>
+double ReferenceGrammar<Grammar>::getProbability(const Rule* rule) const{
+    return this->ruleProbability(rule);
+}
+
+/**
+ * Rule of a converted grammar as text: its type, its probability in hexadecimal floating point, so that the bits of
+ * the probability are compared, and its symbols, the left hand side first.
+ */
+struct RuleLine {
+    int type;
+    string probability;
+    vector<string> symbols;
+};
+
+/**
+ * Returns the rules of a grammar as text, in the order of the rules list.
+ * @param grammar Grammar.
+ * @return Rules of the grammar.
+ */
+template <class Grammar>
+static vector<RuleLine> ruleLines(const ReferenceGrammar<Grammar>& grammar){
+    vector<RuleLine> lines;
+    for (const Rule* rule : grammar.getRules()){
+        char probability[32];
+        snprintf(probability, sizeof(probability), "%a", grammar.getProbability(rule));
+        vector<string> symbols = {rule->getLeftHandSide().getName()};
+        for (const Symbol& symbol : rule->getRightHandSide()){
+            symbols.emplace_back(symbol.getName());
+        }
+        lines.push_back({(int) rule->getRuleType(), probability, symbols});
+    }
+    return lines;
+}
+
+/**
+ * Writes the rules of a converted grammar, one rule per line as its type, its probability and its symbols.
+ * @param fileName Name of the file.
+ * @param lines Rules of the grammar.
+ */
+static void writeRuleLines(const string& fileName, const vector<RuleLine>& lines){
+    ofstream outputFile(fileName);
+    for (const RuleLine& line : lines){
+        outputFile << line.type << " " << line.probability;
+        for (const string& symbol : line.symbols){
+            outputFile << " " << symbol;
+        }
+        outputFile << "\n";
+    }
+}
+
+/**
+ * Reads the rules of a converted grammar written with writeRuleLines.
+ * @param fileName Name of the file.
+ * @return Rules of the grammar, empty if the file can not be read.
+ */
+static vector<RuleLine> readRuleLines(const string& fileName){
+    vector<RuleLine> lines;
+    ifstream inputFile(fileName);
+    string text;
+    while (getline(inputFile, text)){
+        istringstream stream(text);
+        RuleLine line;
+        string symbol;
+        stream >> line.type >> line.probability;
+        while (stream >> symbol){
+            line.symbols.emplace_back(symbol);
+        }
+        lines.emplace_back(line);
+    }
+    return lines;
+}
+
+/**
+ * Returns the name of a symbol with the new X symbols of binarization replaced by the pairs they stand for, such as
+ * (NP (DT NN)), so that grammars numbering their new symbols differently have the same names.
+ * @param symbol Name of the symbol.
+ * @param pairs Pair of symbols of every new symbol.
+ * @param names Names of the new symbols already computed.
+ * @return Name of the symbol independent of the numbering.
+ */
+static string canonicalName(const string& symbol, const unordered_map<string, pair<string, string>>& pairs, unordered_map<string, string>& names){
+    auto pairOfSymbol = pairs.find(symbol);
+    if (pairOfSymbol == pairs.end()){
+        return symbol;
+    }
+    auto name = names.find(symbol);
+    if (name != names.end()){
+        return name->second;
+    }
+    names[symbol] = symbol;
+    string result = "(" + canonicalName(pairOfSymbol->second.first, pairs, names) + " " + canonicalName(pairOfSymbol->second.second, pairs, names) + ")";
+    names[symbol] = result;
+    return result;
+}
+
+/**
+ * Returns the rules of a converted grammar up to the numbering of the new X symbols: every new symbol is replaced by
+ * the pair of symbols it stands for, and the rules are sorted.
+ * @param lines Rules of the converted grammar.
+ * @param originalSymbols Symbols of the grammar before the conversion, which are never renamed.
+ * @return Rules as sorted strings.
+ */
+static vector<string> canonicalRules(const vector<RuleLine>& lines, const unordered_set<string>& originalSymbols){
+    unordered_map<string, pair<string, string>> pairs;
+    for (const RuleLine& line : lines){
+        const string& symbol = line.symbols[0];
+        if (!originalSymbols.contains(symbol) && symbol.size() > 1 && symbol[0] == 'X' && all_of(symbol.begin() + 1, symbol.end(), ::isdigit) && line.symbols.size() == 3){
+            pairs.emplace(symbol, make_pair(line.symbols[1], line.symbols[2]));
+        }
+    }
+    unordered_map<string, string> names;
+    vector<string> result;
+    for (const RuleLine& line : lines){
+        string text = to_string(line.type) + " " + line.probability;
+        for (int i = 0; i < line.symbols.size(); i++){
+            text += (i == 1 ? " -> " : " ") + canonicalName(line.symbols[i], pairs, names);
+        }
+        result.emplace_back(text);
+    }
+    ranges::sort(result);
+    return result;
+}
+
+/**
+ * Compares two converted grammars given as canonical rules, and prints the first differences.
+ * @param name Name of the comparison in the messages.
+ * @param rules Rules of the converted grammar.
+ * @param expected Expected rules.
+ * @return Number of rules occurring in only one of the grammars.
+ */
+static int compareRules(const string& name, const vector<string>& rules, const vector<string>& expected){
+    vector<string> missing, extra;
+    ranges::set_difference(expected, rules, back_inserter(missing));
+    ranges::set_difference(rules, expected, back_inserter(extra));
+    for (int i = 0; i < missing.size() && i < 5; i++){
+        cout << name << ": missing " << missing[i] << endl;
+    }
+    for (int i = 0; i < extra.size() && i < 5; i++){
+        cout << name << ": unexpected " << extra[i] << endl;
+    }
+    cout << name << ": " << rules.size() << " rules, " << missing.size() + extra.size() << " differences" << endl;
+    return missing.size() + extra.size();
+}
+
+/**
+ * Converts two copies of a grammar into Chomsky normal form, one with convertToChomskyNormalForm and one with the
+ * reference algorithm, and compares their rules with their types and the bits of their probabilities, up to the
+ * numbering of the new X symbols. If an expected rule file is given, the conversion is also compared with it, or the
+ * file is rewritten from the conversion when the expected files are updated.
+ * @param name Name of the grammar in the messages.
+ * @param ruleFileName Rule file of the grammar.
+ * @param dictionaryFileName Dictionary file of the grammar.
+ * @param expectedFileName Expected rules of the converted grammar, empty if there are none.
+ * @param update If true, the expected rule file is written instead of compared.
+ * @return Number of differences found.
+ */
+template <class Grammar>
+static int compareConversions(const string& name, const string& ruleFileName, const string& dictionaryFileName, const string& expectedFileName, bool update){
+    ReferenceGrammar<Grammar> converted(ruleFileName, dictionaryFileName, 1), reference(ruleFileName, dictionaryFileName, 1);
+    unordered_set<string> originalSymbols;
+    for (const RuleLine& line : ruleLines(converted)){
+        originalSymbols.insert(line.symbols.begin(), line.symbols.end());
+    }
+    converted.convertToChomskyNormalForm();
+    reference.convertToChomskyNormalFormReference();
+    vector<RuleLine> convertedLines = ruleLines(converted);
+    vector<string> convertedRules = canonicalRules(convertedLines, originalSymbols);
+    int errorCount = compareRules(name, convertedRules, canonicalRules(ruleLines(reference), originalSymbols));
+    if (!expectedFileName.empty()){
+        if (update){
+            writeRuleLines(expectedFileName, convertedLines);
+        } else {
+            vector<RuleLine> expectedLines = readRuleLines(expectedFileName);
+            if (expectedLines.empty()){
+                cout << name << ": can not read " << expectedFileName << endl;
+                errorCount++;
+            } else {
+                errorCount += compareRules(name + " expected", convertedRules, canonicalRules(expectedLines, originalSymbols));
+            }
+        }
+    }
+    return errorCount;
+}
+
+/**
+ * Compares the conversion to Chomsky normal form with the reference algorithm on the grammars shipped in the given
+ * directory and on random grammars with cyclic unary rules and long rules, both as context free and as probabilistic
+ * grammars, and compares the conversions of the shipped grammars with the expected cnf-*.txt rule files of the
+ * directory. Returns a non-zero exit code if any converted grammar differs. With --update, the expected rule files are
+ * rewritten from the current conversion instead.
+ * Usage: ChomskyNormalFormTest directory [--update]
+ */
+int main(int argc, char** argv) {
+    if (argc != 2 && (argc != 3 || string(argv[2]) != "--update")){
+        cerr << "Usage: ChomskyNormalFormTest directory [--update]" << endl;
+        return 1;
+    }
+    filesystem::path directory = argv[1];
+    bool update = argc == 3;
+    int errorCount = 0;
+    errorCount += compareConversions<ContextFreeGrammar>("rule-cfg", (directory / "rule-cfg.txt").string(), (directory / "dictionary-cfg.txt").string(), (directory / "cnf-cfg.txt").string(), update);
+    errorCount += compareConversions<ProbabilisticContextFreeGrammar>("rule-pcfg", (directory / "rule-pcfg.txt").string(), (directory / "dictionary-pcfg.txt").string(), (directory / "cnf-pcfg.txt").string(), update);
+    errorCount += compareConversions<ProbabilisticContextFreeGrammar>("rule-pcfg2", (directory / "rule-pcfg2.txt").string(), (directory / "dictionary-pcfg2.txt").string(), (directory / "cnf-pcfg2.txt").string(), update);
+    filesystem::path temporary = filesystem::temp_directory_path() / "syntactic-parser-cnf-test";
+    filesystem::create_directories(temporary);
+    string ruleFileName = (temporary / "rules.txt").string(), dictionaryFileName = (temporary / "dictionary.txt").string();
+    for (unsigned int seed = 1; seed <= 8; seed++){
+        GrammarGenerator generator(seed, 4 + 2 * seed, 10 * seed, 2, 2, 1 + seed % 3, 1 + seed % 2);
+        string name = "random-" + to_string(seed);
+        generator.writeGrammar(ruleFileName, dictionaryFileName, false);
+        errorCount += compareConversions<ContextFreeGrammar>(name, ruleFileName, dictionaryFileName, "", false);
+        generator.writeGrammar(ruleFileName, dictionaryFileName, true);
+        errorCount += compareConversions<ProbabilisticContextFreeGrammar>(name + "-probabilistic", ruleFileName, dictionaryFileName, "", false);
+    }
+    filesystem::remove_all(temporary);
+    return errorCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include "../ContextFreeGrammar/ContextFreeGrammar.h"
+#include "../ProbabilisticContextFreeGrammar/ProbabilisticContextFreeGrammar.h"
+#include "../ProbabilisticContextFreeGrammar/ProbabilisticRule.h"
+
+/**
+ * Grammar induced from a treebank, which describes itself as text: its symbols in the order of their ids, its lexicon
+ * with the counts of the words, and its rules in the order of the rules list with their types, and for a probabilistic
+ * grammar with their counts and the bits of their probabilities.
+ */
+template <class Grammar>
+class InducedGrammar : public Grammar {
+public:
+    using Grammar::Grammar;
+    [[nodiscard]] vector<string> describe() const;
+};
+
+/**
+ * Returns the description of the grammar, one line per symbol, word and rule.
+ * @return Lines describing the grammar.
+ */
+template <class Grammar>
+vector<string> InducedGrammar<Grammar>::describe() const{
+    vector<string> lines;
+    for (int i = 0; i < this->getSymbolCount(); i++){
+        lines.emplace_back("symbol " + to_string(i) + " " + this->getSymbol(i).getName());
+    }
+    vector<string> words;
+    for (const auto& [word, count] : this->dictionary){
+        words.emplace_back("word " + word + " " + to_string(count));
+    }
+    ranges::sort(words);
+    lines.insert(lines.end(), words.begin(), words.end());
+    for (const Rule* rule : this->rules){
+        string line = "rule " + to_string((int) rule->getRuleType()) + " " + rule->Rule::to_string();
+        auto probabilisticRule = dynamic_cast<const ProbabilisticRule*>(rule);
+        if (probabilisticRule != nullptr){
+            char probability[32];
+            snprintf(probability, sizeof(probability), "%a", probabilisticRule->getProbability());
+            line += " " + to_string(probabilisticRule->getCount()) + " " + probability;
+        }
+        lines.emplace_back(line);
+    }
+    lines.emplace_back("minCount " + to_string(this->minCount));
+    return lines;
+}
+
+/**
+ * Induces a grammar from the trees in the given directory with the serial constructor and with the parallel
+ * constructor with the given number of threads, and compares the descriptions of the two grammars. Every induction
+ * reads the treebank again, since induction replaces the rare words in the trees.
+ * @param name Name of the comparison in the messages.
+ * @param treeBankDirectory Directory of the trees.
+ * @param minCount Minimum frequency parameter.
+ * @param threadCount Number of threads of the parallel constructor.
+ * @return Number of differences found.
+ */
+template <class Grammar>
+static int compareInductions(const string& name, const string& treeBankDirectory, int minCount, int threadCount){
+    TreeBank serialTreeBank(treeBankDirectory), parallelTreeBank(treeBankDirectory);
+    InducedGrammar<Grammar> serial(serialTreeBank, minCount), parallel(parallelTreeBank, minCount, threadCount);
+    vector<string> serialLines = serial.describe(), parallelLines = parallel.describe();
+    int errorCount = 0;
+    if (serialLines.size() != parallelLines.size()){
+        cout << name << ": " << parallelLines.size() << " lines instead of " << serialLines.size() << endl;
+        errorCount++;
+    }
+    for (int i = 0; i < serialLines.size() && i < parallelLines.size(); i++){
+        if (serialLines[i] != parallelLines[i]){
+            if (errorCount < 10){
+                cout << name << ": " << parallelLines[i] << " instead of " << serialLines[i] << endl;
+            }
+            errorCount++;
+        }
+    }
+    cout << name << ": " << serial.size() << " rules, " << errorCount << " differences" << endl;
+    return errorCount;
+}
+
+/**
+ * Compares the grammars induced with the parallel treebank constructors with the ones induced with the serial
+ * constructors, on the treebanks of the given directory, with several thread counts and minimum frequencies, both as
+ * context free and as probabilistic grammars. The grammars must be identical, including the ids of the symbols and
+ * the bits of the probabilities. Returns a non-zero exit code if any grammar differs.
+ * Usage: ParallelInductionTest directory
+ */
+int main(int argc, char** argv) {
+    if (argc != 2){
+        cerr << "Usage: ParallelInductionTest directory" << endl;
+        return 1;
+    }
+    filesystem::path directory = argv[1];
+    int errorCount = 0;
+    for (const string treeBankName : {"trees", "trees2"}){
+        string treeBankDirectory = (directory / treeBankName).string();
+        for (int minCount : {1, 2}){
+            for (int threadCount : {1, 2, 3, 8}){
+                string name = treeBankName + " minCount " + to_string(minCount) + " threads " + to_string(threadCount);
+                errorCount += compareInductions<ContextFreeGrammar>(name, treeBankDirectory, minCount, threadCount);
+                errorCount += compareInductions<ProbabilisticContextFreeGrammar>(name + " probabilistic", treeBankDirectory, minCount, threadCount);
+            }
+        }
+    }
+    return errorCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include "../Benchmarks/GrammarGenerator.h"
+#include "../ProbabilisticContextFreeGrammar/ProbabilisticParseNode.h"
+#include "../ProbabilisticParser/AStarParser.h"
+#include "../ProbabilisticParser/EarleyParser.h"
+#include "../ProbabilisticParser/ViterbiCYKParser.h"
+
+/**
+ * Returns the log probability of the best parse tree returned by a parser, which the parsers store at the root of the
+ * tree, and deletes the parse trees.
+ * @param parseTrees Parse trees returned by a parser.
+ * @return Log probability of the first parse tree, -infinity if there is none.
+ */
+static double bestLogProbability(const vector<ParseTree*>& parseTrees){
+    double result = -numeric_limits<double>::infinity();
+    if (!parseTrees.empty()){
+        result = ((const ProbabilisticParseNode*) parseTrees[0]->getRoot())->getLogProbability();
+    }
+    for (ParseTree* parseTree : parseTrees){
+        delete parseTree;
+    }
+    return result;
+}
+
+/**
+ * Checks if two parsers found the same best log probability for a sentence. The parsers add the log probabilities of
+ * the rules in different orders, so the scores may differ in the last bits.
+ * @param name Name of the comparison in the messages.
+ * @param logProbability Log probability found by the parser under test.
+ * @param expected Log probability of the Viterbi parse.
+ * @return 1 if the log probabilities differ, 0 otherwise.
+ */
+static int compareScores(const string& name, double logProbability, double expected){
+    if (logProbability == expected || fabs(logProbability - expected) <= 1e-9 * max(1.0, fabs(expected))){
+        return 0;
+    }
+    cout << name << ": " << logProbability << " instead of " << expected << endl;
+    return 1;
+}
+
+/**
+ * Parses sentences generated from a random grammar with ViterbiCYKParser, AStarParser and EarleyParser, and compares
+ * the log probabilities of their best parses. The Viterbi and A* parsers use the grammar binarized with its unary rules
+ * kept, and the grammar in Chomsky normal form without unary rules; the Earley parser uses the grammar as it is, whose
+ * best parses have the same log probabilities as the ones of the binarized grammar. The A* parser must reject the
+ * grammar as it is, since it has rules with more than two symbols on the right hand side.
+ * @param seed Seed of the random grammar.
+ * @param ruleFileName Temporary rule file.
+ * @param dictionaryFileName Temporary dictionary file.
+ * @return Number of differences found.
+ */
+static int compareParsers(unsigned int seed, const string& ruleFileName, const string& dictionaryFileName){
+    GrammarGenerator generator(seed, 6 + 2 * seed, 20 * seed, 2, 2, 1 + seed % 2, 1);
+    generator.writeGrammar(ruleFileName, dictionaryFileName, true);
+    ProbabilisticContextFreeGrammar original(ruleFileName, dictionaryFileName, 1), binarized(ruleFileName, dictionaryFileName, 1), normal(ruleFileName, dictionaryFileName, 1);
+    binarized.convertToChomskyNormalForm(false);
+    normal.convertToChomskyNormalForm();
+    ViterbiCYKParser viterbiParser;
+    AStarParser aStarParser;
+    EarleyParser earleyParser;
+    string name = "random-" + to_string(seed);
+    int errorCount = 0, parsedCount = 0;
+    try {
+        bestLogProbability(aStarParser.parse(original, generator.generateSentence(3)));
+        cout << name << ": AStarParser accepted a grammar with rules of more than two symbols" << endl;
+        errorCount++;
+    } catch (const invalid_argument&){
+    }
+    for (int i = 0; i < 20; i++){
+        vector<string> words = generator.generateSentence(2 + i % 10);
+        string sentenceName = name + " sentence " + to_string(i);
+        double viterbi = bestLogProbability(viterbiParser.parse(binarized, words));
+        errorCount += compareScores(sentenceName + " AStarParser", bestLogProbability(aStarParser.parse(binarized, words)), viterbi);
+        errorCount += compareScores(sentenceName + " EarleyParser", bestLogProbability(earleyParser.parse(original, words)), viterbi);
+        double normalViterbi = bestLogProbability(viterbiParser.parse(normal, words));
+        errorCount += compareScores(sentenceName + " AStarParser in Chomsky normal form", bestLogProbability(aStarParser.parse(normal, words)), normalViterbi);
+        parsedCount += viterbi != -numeric_limits<double>::infinity();
+    }
+    cout << name << ": " << parsedCount << " of 20 sentences parsed, " << errorCount << " differences" << endl;
+    return errorCount;
+}
+
+/**
+ * Compares the best parses of AStarParser and EarleyParser with the Viterbi parses of ViterbiCYKParser on sentences of
+ * random grammars with unary rules and long rules. Returns a non-zero exit code if any log probability differs.
+ * Usage: ParserScoreTest
+ */
+int main() {
+    filesystem::path temporary = filesystem::temp_directory_path() / "syntactic-parser-score-test";
+    filesystem::create_directories(temporary);
+    string ruleFileName = (temporary / "rules.txt").string(), dictionaryFileName = (temporary / "dictionary.txt").string();
+    int errorCount = 0;
+    for (unsigned int seed = 1; seed <= 6; seed++){
+        errorCount += compareParsers(seed, ruleFileName, dictionaryFileName);
+    }
+    filesystem::remove_all(temporary);
+    return errorCount == 0 ? 0 : 1;
+}
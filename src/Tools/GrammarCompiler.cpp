@@ -0,0 +1,76 @@
+//
+// Created by Olcay Taner YILDIZ on 17.10.2026.
+//
+
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include "../ContextFreeGrammar/ContextFreeGrammar.h"
+#include "../ProbabilisticContextFreeGrammar/ProbabilisticContextFreeGrammar.h"
+
+/**
+ * Converts a grammar stored as rule-*.txt and dictionary-*.txt files into the compiled binary format, which the
+ * grammar classes load with their binary file constructors.
+ * Usage: GrammarCompiler [--probabilistic] [--cnf | --binarize] ruleFile dictionaryFile minCount outputFile
+ * --probabilistic reads the rules with their probabilities, --cnf converts the grammar into Chomsky normal form before
+ * writing, so that the parsers can use the compiled grammar as it is. --binarize converts it into Chomsky normal form
+ * keeping the unary rules, which the parsers apply with the unary closure of the grammar.
+ */
+int main(int argc, char** argv) {
+    bool probabilistic = false, chomskyNormalForm = false, removeUnaryRules = true;
+    vector<string> arguments;
+    for (int i = 1; i < argc; i++){
+        string argument = argv[i];
+        if (argument == "--probabilistic"){
+            probabilistic = true;
+        } else {
+            if (argument == "--cnf" || argument == "--binarize"){
+                chomskyNormalForm = true;
+                removeUnaryRules = argument == "--cnf";
+            } else {
+                arguments.emplace_back(argument);
+            }
+        }
+    }
+    if (arguments.size() != 4){
+        cerr << "Usage: GrammarCompiler [--probabilistic] [--cnf | --binarize] ruleFile dictionaryFile minCount outputFile" << endl;
+        return 1;
+    }
+    unique_ptr<ContextFreeGrammar> grammar, compiled;
+    if (probabilistic){
+        auto pCfg = make_unique<ProbabilisticContextFreeGrammar>(arguments[0], arguments[1], stoi(arguments[2]));
+        if (chomskyNormalForm){
+            pCfg->convertToChomskyNormalForm(removeUnaryRules);
+        }
+        grammar = std::move(pCfg);
+    } else {
+        grammar = make_unique<ContextFreeGrammar>(arguments[0], arguments[1], stoi(arguments[2]));
+        if (chomskyNormalForm){
+            grammar->convertToChomskyNormalForm(removeUnaryRules);
+        }
+    }
+    if (grammar->size() == 0){
+        cerr << "No rules read from " << arguments[0] << endl;
+        return 1;
+    }
+    if (!grammar->saveBinary(arguments[3])){
+        cerr << "Can not write " << arguments[3] << endl;
+        return 1;
+    }
+    try {
+        if (probabilistic){
+            compiled = make_unique<ProbabilisticContextFreeGrammar>(arguments[3]);
+        } else {
+            compiled = make_unique<ContextFreeGrammar>(arguments[3]);
+        }
+    } catch (const invalid_argument&){
+        cerr << "Can not read back " << arguments[3] << endl;
+        return 1;
+    }
+    if (compiled->size() != grammar->size()){
+        cerr << "Can not read back " << arguments[3] << endl;
+        return 1;
+    }
+    cout << arguments[3] << ": " << compiled->size() << " rules, " << compiled->getSymbolCount() << " symbols" << endl;
+    return 0;
+}